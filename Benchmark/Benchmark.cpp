@@ -0,0 +1,343 @@
+#include <vector>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <experimental\filesystem>
+#include <windows.h>
+#include <psapi.h>
+#include "../SendToTembo/DataReader.h"
+#include "../SendToTembo/CSVReader.h"
+#include "../SendToTembo/EFFReader.h"
+#include "Fixtures.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+namespace filesys = std::experimental::filesystem;
+using namespace std;
+
+/*************************************************************************************************************************************************************************
+* End to end benchmark of the converter on generated lots
+*
+* Usage:	Benchmark.exe <work_folder> [scale] [name=value ...] [label=text]
+*
+*		work_folder		fixtures are written to work_folder\fixtures, JSON to work_folder\out
+*		scale			multiplies CSV and EFF rows (default 1)
+*		name=value		size of the lot, see FixtureSize (e.g. out_columns=50 eff_columns=1000 png_files=0)
+*		label			name of the run in work_folder\benchmark_results.csv, e.g. the converter version
+*
+* Every phase reports throughput and the peak working set while it ran. Results are appended to benchmark_results.csv, so runs of
+* two releases on the same size can be compared. The conversion cache is not used, every run parses all files.
+* Built from the files of this folder and all files of SendToTembo except Main.cpp, linked with psapi.lib.
+*
+*************************************************************************************************************************************************************************/
+
+// gives the benchmark access to the JSON writer of the readers
+class BenchmarkWriter : public DataReader
+{
+
+public:
+	using DataReader::json_writer;
+
+	// value objects like the ones of a CSV file with out_columns columns and conditions param columns
+	vector<DataObject> make_data_objects(size_t num_objects, int out_columns, int conditions) {
+		vector<DataObject> data_objects(num_objects);
+		PooledString dut_id = this->string_pool->intern(L"7");
+		PooledString user_name_key = this->string_pool->intern(L"user_name");
+		PooledString user_name = this->string_pool->intern(L"BenchUser");
+		shared_ptr<const RowMetaData> row;
+		for (size_t i = 0; i < num_objects; i++) {
+			// out_columns objects per row share its meta data
+			if (i % max(1, out_columns) == 0) {
+				RowMetaData row_meta_data;
+				row_meta_data.dut_id = dut_id;
+				for (int j = 0; j < conditions; j++) {
+					row_meta_data.set_cond(this->string_pool->intern(L"cond_c" + to_wstring(j)), this->string_pool->intern(to_wstring((i / max(1, out_columns) + j) % 100)));
+				}
+				row_meta_data.set_meta(user_name_key, user_name);
+				row = make_shared<const RowMetaData>(move(row_meta_data));
+			}
+			DataObject& data_object = data_objects[i];
+			data_object.test_name = this->string_pool->intern(L"p" + to_wstring(i % max(1, out_columns)));
+			data_object.test_number = to_string(1000 + i % max(1, out_columns));
+			data_object.row = row;
+			data_object.value = to_string((double)i * 0.001);
+		}
+		return data_objects;
+	}
+};
+
+// samples the working set of the process while a phase runs
+class MemorySampler
+{
+
+private:
+	thread sampler;
+	atomic<bool> running{ false };
+	atomic<size_t> peak{ 0 };
+
+	static size_t working_set() {
+		PROCESS_MEMORY_COUNTERS counters;
+		if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+			return 0;
+		}
+		return counters.WorkingSetSize;
+	}
+
+public:
+	void start() {
+		peak = working_set();
+		running = true;
+		sampler = thread([this]() {
+			while (running) {
+				size_t current = working_set();
+				if (current > peak) {
+					peak = current;
+				}
+				this_thread::sleep_for(chrono::milliseconds(5));
+			}
+		});
+	}
+
+	// peak working set in bytes since start
+	size_t stop() {
+		running = false;
+		sampler.join();
+		size_t current = working_set();
+		return max((size_t)peak, current);
+	}
+};
+
+struct PhaseResult {
+	wstring name;
+	double ms = 0;
+	size_t rows = 0;
+	size_t objects = 0;
+	uintmax_t bytes = 0;
+	size_t peak_memory = 0;
+};
+
+static uintmax_t total_size(const vector<wstring>& files) {
+	uintmax_t size = 0;
+	for (const wstring& file : files) {
+		error_code ec;
+		uintmax_t file_size = filesys::file_size(file, ec);
+		size += ec ? 0 : file_size;
+	}
+	return size;
+}
+
+// number of data objects in a JSON written by the converter
+static size_t count_data_objects(const wstring& json_file) {
+	ifstream in(json_file, ios::in | ios::binary);
+	string content((istreambuf_iterator<char>(in)), istreambuf_iterator<char>());
+	size_t count = 0;
+	for (size_t pos = content.find("\"metaData\":"); pos != string::npos; pos = content.find("\"metaData\":", pos + 1)) {
+		count++;
+	}
+	return count;
+}
+
+static void print_result(const PhaseResult& result) {
+	double seconds = max(result.ms, 0.001) / 1000.0;
+	wcout << left << setw(18) << result.name << right << fixed << setprecision(1)
+		<< setw(12) << result.ms
+		<< setw(14) << (result.rows > 0 ? result.rows / seconds : 0.0)
+		<< setw(14) << (result.objects > 0 ? result.objects / seconds : 0.0)
+		<< setw(10) << (result.bytes / (1024.0 * 1024.0)) / seconds
+		<< setw(12) << result.peak_memory / (1024.0 * 1024.0) << endl;
+}
+
+int main(int argc, char *argv[]) {
+	typedef std::chrono::high_resolution_clock clock;
+	typedef std::chrono::duration<double, std::milli> mil;
+
+	std::setlocale(LC_ALL, "en_US.utf8");
+
+	if (argc < 2) {
+		wcout << L"Usage: Benchmark.exe <work_folder> [scale] [name=value ...] [label=text]" << endl;
+		return 1;
+	}
+	string path = argv[1];
+	wstring work_folder(path.begin(), path.end());
+	FixtureSize size;
+	wstring label = L"unnamed";
+	for (int i = 2; i < argc; i++) {
+		string arg = argv[i];
+		wstring warg(arg.begin(), arg.end());
+		size_t equal_sign = warg.find(L'=');
+		if (equal_sign == wstring::npos) {
+			try {
+				size.scale(max(1, stoi(warg)));
+			}
+			catch (exception &e) {
+				wcout << L"Invalid scale: " << warg << endl;
+				return 1;
+			}
+		}
+		else if (warg.substr(0, equal_sign) == L"label") {
+			label = warg.substr(equal_sign + 1);
+		}
+		else if (!size.set(warg.substr(0, equal_sign), warg.substr(equal_sign + 1))) {
+			wcout << L"Invalid size: " << warg << endl;
+			return 1;
+		}
+	}
+
+	wstring fixture_folder = work_folder + L"\\fixtures";
+	wstring out_folder = work_folder + L"\\out";
+	error_code ec;
+	filesys::create_directories(out_folder, ec);
+
+	wcout << L"Generating fixtures in " << fixture_folder << endl;
+	wcout << L"csv_files=" << size.csv_files << L" csv_rows=" << size.csv_rows << L" out_columns=" << size.out_columns
+		<< L" conditions=" << size.conditions << L" meta_blocks=" << size.meta_blocks << L" eff_files=" << size.eff_files
+		<< L" eff_rows=" << size.eff_rows << L" eff_columns=" << size.eff_columns << L" png_files=" << size.png_files
+		<< L" mat_files=" << size.mat_files << endl;
+	Fixtures fixtures;
+	if (!fixtures.generate(fixture_folder, size)) {
+		wcout << L"Couldn't write fixtures" << endl;
+		return 1;
+	}
+
+	// converter output goes to a log, only the results are printed
+	wostringstream converter_log;
+	vector<PhaseResult> results;
+	MemorySampler sampler;
+	DataReader dr;
+	dr.set_log_stream(&converter_log);
+
+	// testlimits.txt
+	{
+		PhaseResult result;
+		result.name = L"read_limits_file";
+		CSVReader cr;
+		cr.set_log_stream(&converter_log);
+		sampler.start();
+		auto t1 = clock::now();
+		LimitsIndex limits_struct = cr.read_limits_file(fixtures.get_limits_file());
+		auto t2 = clock::now();
+		result.peak_memory = sampler.stop();
+		result.ms = mil(t2 - t1).count();
+		result.rows = limits_struct.size();
+		result.bytes = total_size({ fixtures.get_limits_file() });
+		results.push_back(result);
+	}
+
+	// all CSV files into one report
+	if (!fixtures.get_csv_files().empty()) {
+		PhaseResult result;
+		result.name = L"csvs_to_json";
+		CSVReader cr;
+		cr.set_log_stream(&converter_log);
+		map<wstring, wstring> raw_configs_struct;
+		raw_configs_struct[L"Project"] = L"psn-benchmark";
+		raw_configs_struct[L"name_report"] = L"Benchmark";
+		raw_configs_struct[L"Email"] = L"benchmark@infineon.com";
+		map<wstring, wstring> configs_struct = dr.setup_configurations(raw_configs_struct, true);
+		sampler.start();
+		auto t1 = clock::now();
+		LimitsIndex limits_struct = cr.read_limits_file(fixtures.get_limits_file());
+		bool res = cr.csvs_to_json(fixtures.get_csv_files(), limits_struct, configs_struct, out_folder, fixtures.get_png_files(), fixtures.get_mat_files());
+		auto t2 = clock::now();
+		result.peak_memory = sampler.stop();
+		if (!res) {
+			wcout << converter_log.str() << L"csvs_to_json failed" << endl;
+			return 1;
+		}
+		result.ms = mil(t2 - t1).count();
+		result.rows = fixtures.get_num_csv_rows();
+		result.objects = count_data_objects(out_folder + L"\\Benchmark.json");
+		result.bytes = total_size(fixtures.get_csv_files());
+		results.push_back(result);
+	}
+
+	// every EFF file into its own report, one after another
+	if (!fixtures.get_eff_files().empty()) {
+		PhaseResult result;
+		result.name = L"eff_to_json";
+		map<wstring, wstring> raw_configs_struct;
+		raw_configs_struct[L"Project"] = L"psn-benchmark";
+		raw_configs_struct[L"Email"] = L"benchmark@infineon.com";
+		map<wstring, wstring> configs_struct = dr.setup_configurations(raw_configs_struct, false);
+		sampler.start();
+		auto t1 = clock::now();
+		for (const wstring& eff_file : fixtures.get_eff_files()) {
+			EFFReader er;
+			er.set_log_stream(&converter_log);
+			if (!er.eff_to_json(eff_file, configs_struct, out_folder)) {
+				sampler.stop();
+				wcout << converter_log.str() << L"eff_to_json failed: " << eff_file << endl;
+				return 1;
+			}
+		}
+		auto t2 = clock::now();
+		result.peak_memory = sampler.stop();
+		result.ms = mil(t2 - t1).count();
+		result.rows = fixtures.get_num_eff_rows();
+		for (const wstring& eff_file : fixtures.get_eff_files()) {
+			wstring base_filename = eff_file.substr(eff_file.find_last_of(L"/\\") + 1);
+			result.objects += count_data_objects(out_folder + L"\\" + base_filename.substr(0, base_filename.find_last_of('.')) + L".json");
+		}
+		result.bytes = total_size(fixtures.get_eff_files());
+		results.push_back(result);
+	}
+
+	// JSON writer alone, objects of the size of the CSV report
+	{
+		PhaseResult result;
+		result.name = L"json_writer";
+		BenchmarkWriter writer;
+		writer.set_log_stream(&converter_log);
+		size_t num_objects = max((size_t)1, fixtures.get_num_csv_rows() * size.out_columns);
+		vector<DataObject> data_objects = writer.make_data_objects(num_objects, size.out_columns, size.conditions);
+		map<wstring, wstring> header;
+		header[L"version"] = L"1.0.1";
+		map<wstring, wstring> common_meta_data;
+		common_meta_data[L"user_name"] = L"BenchUser";
+		wstring json_path = out_folder + L"\\json_writer.json";
+		sampler.start();
+		auto t1 = clock::now();
+		bool res = writer.json_writer(header, common_meta_data, &data_objects, json_path, L"{}");
+		auto t2 = clock::now();
+		result.peak_memory = sampler.stop();
+		if (!res) {
+			wcout << L"json_writer failed" << endl;
+			return 1;
+		}
+		result.ms = mil(t2 - t1).count();
+		result.objects = num_objects;
+		result.bytes = total_size({ json_path });
+		results.push_back(result);
+	}
+
+	wcout << endl << left << setw(18) << L"phase" << right << setw(12) << L"ms" << setw(14) << L"rows/s" << setw(14) << L"objects/s"
+		<< setw(10) << L"MB/s" << setw(12) << L"peak MB" << endl;
+	for (const PhaseResult& result : results) {
+		print_result(result);
+	}
+
+	// one line per phase, so runs of different releases can be compared in Excel
+	wstring results_file = work_folder + L"\\benchmark_results.csv";
+	bool new_file = !filesys::exists(results_file, ec);
+	wofstream out(results_file, ios::out | ios::app);
+	if (new_file) {
+		out << L"label;csv_rows;eff_rows;phase;ms;rows;objects;bytes;peak_memory" << endl;
+	}
+	for (const PhaseResult& result : results) {
+		out << label << L";" << size.csv_rows << L";" << size.eff_rows << L";" << result.name << L";" << result.ms << L";" << result.rows << L";"
+			<< result.objects << L";" << result.bytes << L";" << result.peak_memory << endl;
+	}
+	wcout << endl << L"Results added to " << results_file << endl;
+
+	return 0;
+}
@@ -0,0 +1,257 @@
+#include "Fixtures.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+namespace filesys = std::experimental::filesystem;
+
+bool FixtureSize::set(const wstring& name, const wstring& value) {
+	map<wstring, int*> fields = {
+		{ L"csv_files", &csv_files }, { L"csv_rows", &csv_rows }, { L"out_columns", &out_columns }, { L"conditions", &conditions },
+		{ L"meta_blocks", &meta_blocks }, { L"eff_files", &eff_files }, { L"eff_rows", &eff_rows }, { L"eff_columns", &eff_columns },
+		{ L"png_files", &png_files }, { L"mat_files", &mat_files }
+	};
+	auto field = fields.find(name);
+	if (field == fields.end()) {
+		return false;
+	}
+	try {
+		*field->second = max(0, stoi(value));
+	}
+	catch (exception &e) {
+		return false;
+	}
+	return true;
+}
+
+Fixtures::Fixtures() : random(20261018) {
+}
+
+Fixtures::~Fixtures() {
+}
+
+wstring Fixtures::random_value() {
+	// 10 % empty cells, the rest spread over several decades like real measurements
+	uniform_int_distribution<int> empty(0, 9);
+	if (empty(random) == 0) {
+		return L"";
+	}
+	uniform_real_distribution<double> mantissa(-1000.0, 1000.0);
+	uniform_int_distribution<int> exponent(-9, 0);
+	return to_wstring(mantissa(random) * pow(10.0, exponent(random)));
+}
+
+bool Fixtures::generate(const wstring& root, const FixtureSize& size) {
+	csv_files.clear();
+	eff_files.clear();
+	png_files.clear();
+	mat_files.clear();
+	num_csv_rows = 0;
+	num_eff_rows = 0;
+
+	wstring test_flow_folder = root + L"\\20_TestFlow";
+	wstring raw_data_folder = root + L"\\30_RawData";
+	error_code ec;
+	filesys::create_directories(test_flow_folder, ec);
+	filesys::create_directories(raw_data_folder, ec);
+
+	this->write_limits_file(size, test_flow_folder);
+	for (int i = 0; i < size.csv_files; i++) {
+		// a few files per lot folder, like several measurement runs
+		wstring lot_folder = raw_data_folder + L"\\lot" + to_wstring(i / 4);
+		filesys::create_directories(lot_folder, ec);
+		this->write_csv_file(size, i, lot_folder);
+	}
+	for (int i = 0; i < size.eff_files; i++) {
+		this->write_eff_file(size, i, raw_data_folder);
+	}
+
+	for (const wstring& file : csv_files) {
+		if (!filesys::exists(file, ec)) {
+			return false;
+		}
+	}
+	for (const wstring& file : eff_files) {
+		if (!filesys::exists(file, ec)) {
+			return false;
+		}
+	}
+	return filesys::exists(limits_file, ec);
+}
+
+void Fixtures::write_limits_file(const FixtureSize& size, const wstring& test_flow_folder) {
+	limits_file = test_flow_folder + L"\\testlimits.txt";
+	wofstream out(limits_file);
+	out << L"# key LSL USL Typ Unit TestNr ReqID Description" << endl;
+	out << L"# generated by Benchmark" << endl;
+	uniform_int_distribution<int> lower(0, 5);
+	uniform_int_distribution<int> upper(6, 20);
+	for (int i = 0; i < size.out_columns; i++) {
+		out << L"p" << i << L" " << lower(random) << L" " << upper(random) << L" 5 mA " << 1000 + i << L" R" << i
+			<< L" description of p" << i << L" with a few words" << endl;
+	}
+}
+
+void Fixtures::write_csv_file(const FixtureSize& size, int file_index, const wstring& lot_folder) {
+	wstring csv_file = lot_folder + L"\\data" + to_wstring(file_index) + L".csv";
+	csv_files.push_back(csv_file);
+	wofstream out(csv_file);
+
+	const wchar_t* cond_names[] = { L"vio", L"temp", L"vbat", L"freq", L"load", L"mode" };
+	const wchar_t* cond_values[] = { L"1.5", L"3.3", L"5", L"-40", L"25", L"150" };
+	int num_cond_names = sizeof(cond_names) / sizeof(cond_names[0]);
+	int num_cond_values = sizeof(cond_values) / sizeof(cond_values[0]);
+	// sweep first, further conditions are named cond6, cond7, ...
+	vector<wstring> conds;
+	for (int i = 0; i < size.conditions; i++) {
+		conds.push_back(i < num_cond_names ? cond_names[i] : L"cond" + to_wstring(i));
+	}
+
+	int dut_id = file_index * max(1, size.meta_blocks);
+	out << L"#meta,user:BenchUser,basic_type:S12" << file_index % 3 << L",product_sales_code:SP001,product_design_step:A1,package:PG-TSDSO-14,dut_id:"
+		<< dut_id << endl;
+
+	// header rows
+	out << L"Columns type";
+	for (int i = 0; i < size.conditions; i++) {
+		out << L";param";
+	}
+	for (int i = 0; i < size.out_columns; i++) {
+		out << L";out";
+	}
+	out << L";comment;comment;comment" << endl;
+	out << L"Variables";
+	for (const wstring& cond : conds) {
+		out << L";" << cond;
+	}
+	for (int i = 0; i < size.out_columns; i++) {
+		out << L";p" << i;
+	}
+	out << L";note;PicturePath;WaveformPath" << endl;
+	out << L"Units";
+	for (int i = 0; i < size.conditions; i++) {
+		out << L";V";
+	}
+	for (int i = 0; i < size.out_columns; i++) {
+		out << (i % 3 == 0 ? L";mA" : i % 3 == 1 ? L";uV" : L";kOhm");
+	}
+	out << L";;;" << endl;
+	if (file_index % 2 == 0) {
+		// every other file overrides the limits of testlimits.txt
+		out << L"LSL";
+		for (int i = 0; i < size.conditions; i++) {
+			out << L";";
+		}
+		for (int i = 0; i < size.out_columns; i++) {
+			out << L";-" << i;
+		}
+		out << L";;;" << endl;
+		out << L"USL";
+		for (int i = 0; i < size.conditions; i++) {
+			out << L";";
+		}
+		for (int i = 0; i < size.out_columns; i++) {
+			out << L";" << i + 10;
+		}
+		out << L";;;" << endl;
+	}
+
+	int rows_per_block = max(1, size.csv_rows / max(1, size.meta_blocks));
+	int png_step = size.png_files > 0 ? max(1, size.csv_rows / size.png_files) : 0;
+	int mat_step = size.mat_files > 0 ? max(1, size.csv_rows / size.mat_files) : 0;
+	int num_png = 0;
+	int num_mat = 0;
+	for (int row = 0; row < size.csv_rows; row++) {
+		if (row > 0 && row % rows_per_block == 0) {
+			dut_id++;
+			out << L"#meta,dut_id:" << dut_id << endl;
+		}
+		// first condition sweeps, so every row is a new combination
+		vector<wstring> values;
+		for (int i = 0; i < size.conditions; i++) {
+			values.push_back(i == 0 ? to_wstring(row % 1000) + L"." + to_wstring(row / 1000) : cond_values[(row / (i + 1)) % num_cond_values]);
+		}
+		wstring pic_name;
+		wstring waveform_name;
+		if (png_step > 0 && row % png_step == 0 && num_png < size.png_files) {
+			pic_name = L"Report-picture_" + to_wstring(row) + L".png";
+			num_png++;
+		}
+		if (mat_step > 0 && row % mat_step == 0 && num_mat < size.mat_files) {
+			waveform_name = L"wave_" + to_wstring(row) + L".mat";
+			num_mat++;
+		}
+
+		out << row;
+		for (const wstring& value : values) {
+			out << L";" << value;
+		}
+		for (int i = 0; i < size.out_columns; i++) {
+			out << L";" << this->random_value();
+		}
+		out << L";" << (row % 2 ? L"note " + to_wstring(row) : L"") << L";" << pic_name << L";" << waveform_name << endl;
+
+		// media folders are named after sample and conditions of the row
+		wstring media_folder = lot_folder + L"\\sample=" + to_wstring(dut_id);
+		for (int i = 0; i < size.conditions; i++) {
+			media_folder += L"_" + conds[i] + L"=" + values[i] + L"[V]";
+		}
+		if (!pic_name.empty()) {
+			png_files.push_back(media_folder + L"\\" + pic_name);
+		}
+		if (!waveform_name.empty()) {
+			mat_files.push_back(media_folder + L"_Report-waveform\\" + waveform_name);
+		}
+	}
+	num_csv_rows += size.csv_rows;
+}
+
+void Fixtures::write_eff_file(const FixtureSize& size, int file_index, const wstring& raw_data_folder) {
+	wstring eff_file = raw_data_folder + L"\\lot" + to_wstring(file_index) + L"_final_test.eff";
+	eff_files.push_back(eff_file);
+	wofstream out(eff_file);
+
+	out << L"<<EFF:1.00>>;Ref=BenchUser;generated by Benchmark" << endl;
+	out << L"<+EFF:1.00>;design;dut;temp;vio;cnt";
+	for (int i = 0; i < size.eff_columns; i++) {
+		out << L";" << 100 + i;
+	}
+	out << endl;
+	out << L"<+PName>;;;;;";
+	for (int i = 0; i < size.eff_columns; i++) {
+		out << L";par-" << i << L".x";
+	}
+	out << endl;
+	out << L"<Unit>;;;;;";
+	for (int i = 0; i < size.eff_columns; i++) {
+		out << (i % 4 == 0 ? L";mA" : i % 4 == 1 ? L";uV" : i % 4 == 2 ? L";V" : L";GHz");
+	}
+	out << endl;
+	out << L"<USL>;;;;;";
+	for (int i = 0; i < size.eff_columns; i++) {
+		out << (i % 3 == 0 ? L";" : L";7.5");
+	}
+	out << endl;
+	out << L"<LSL>;;;;;";
+	for (int i = 0; i < size.eff_columns; i++) {
+		out << (i % 3 == 0 ? L";" : L";-0.001");
+	}
+	out << endl;
+
+	const wchar_t* temps[] = { L"-40", L"25", L"150" };
+	for (int row = 0; row < size.eff_rows; row++) {
+		// dut isn't a condition, cnt makes every row a new combination
+		out << L"05_Die;S12_A1" << (row % 2 ? L"_SPX" : L"") << L";" << row / 10 << L";" << temps[row % 3] << L";" << 1 + row % 2 << L";" << row;
+		for (int i = 0; i < size.eff_columns; i++) {
+			out << L";" << this->random_value();
+		}
+		out << endl;
+	}
+	num_eff_rows += size.eff_rows;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <fstream>
+#include <experimental/filesystem>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* Size of a generated lot
+*
+* All counts can be set with name=value on the command line of the benchmark, scale multiplies csv_rows and eff_rows.
+*
+*************************************************************************************************************************************************************************/
+struct FixtureSize
+{
+	int csv_files = 8;
+	// data rows per CSV file
+	int csv_rows = 2000;
+	// out columns per CSV file, every out column has a line in testlimits.txt
+	int out_columns = 20;
+	// param columns per CSV file
+	int conditions = 3;
+	// #meta lines per CSV file, first one at the top with all fields, the others only change dut_id
+	int meta_blocks = 4;
+	int eff_files = 2;
+	int eff_rows = 20000;
+	// test columns per EFF file
+	int eff_columns = 200;
+	// png and mat files per CSV file
+	int png_files = 100;
+	int mat_files = 20;
+
+	// sets a field by its name, returns false for unknown names or invalid values
+	bool set(const wstring& name, const wstring& value);
+	void scale(int factor) { csv_rows *= factor; eff_rows *= factor; }
+};
+
+
+/*************************************************************************************************************************************************************************
+* Synthetic 30_RawData / 20_TestFlow tree for the benchmark
+*
+* Files look like the ones of a real lot: CSV files with #meta lines, LSL/USL rows, PicturePath and WaveformPath comments, png and
+* mat files in sample=<dut>_<cond>=<value>[x] folders, EFF files with header lines and limits. Values come from a fixed seed, so the
+* same size always gives the same files.
+* png and mat files are only listed, not created, the converter only looks at their names.
+*
+*************************************************************************************************************************************************************************/
+class Fixtures
+{
+
+private:
+	mt19937 random;
+
+	vector<wstring> csv_files;
+	vector<wstring> eff_files;
+	vector<wstring> png_files;
+	vector<wstring> mat_files;
+	wstring limits_file;
+	size_t num_csv_rows = 0;
+	size_t num_eff_rows = 0;
+
+	wstring random_value();
+	void write_limits_file(const FixtureSize& size, const wstring& test_flow_folder);
+	void write_csv_file(const FixtureSize& size, int file_index, const wstring& lot_folder);
+	void write_eff_file(const FixtureSize& size, int file_index, const wstring& raw_data_folder);
+
+public:
+	Fixtures();
+	~Fixtures();
+
+
+	/*************************************************************************************************************************************************************************
+	* This function writes a lot of the given size
+	*
+	* Input:
+	*		root			wstring				folder to write 20_TestFlow and 30_RawData into, created if it doesn't exist
+	*		size			FixtureSize			number of files, rows and columns
+	* Output:
+	*		res				bool				whether all files could be written
+	*
+	*************************************************************************************************************************************************************************/
+	bool generate(const wstring&, const FixtureSize&);
+
+	const vector<wstring>& get_csv_files() const { return csv_files; }
+	const vector<wstring>& get_eff_files() const { return eff_files; }
+	const vector<wstring>& get_png_files() const { return png_files; }
+	const vector<wstring>& get_mat_files() const { return mat_files; }
+	const wstring& get_limits_file() const { return limits_file; }
+	size_t get_num_csv_rows() const { return num_csv_rows; }
+	size_t get_num_eff_rows() const { return num_eff_rows; }
+};
+
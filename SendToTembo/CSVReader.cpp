@@ -16,23 +16,40 @@ CSVReader::CSVReader() {
 CSVReader::~CSVReader() {
 }
 
-map <wstring, map <wstring, wstring>> CSVReader::read_limits_file(const wstring& limits_file_path) {
+LimitsIndex CSVReader::read_limits_file(const wstring& limits_file_path) {
 	vector <wstring> headers_arr;	// to store array of headers
 	vector <wstring> limits_arr;		// to store array of limit values for each line
-	map <wstring, map <wstring, wstring>> limits_struct;	// final structure to store all limits with corresponding key => value pairs
-
-	wifstream inf(limits_file_path);
-	if (!inf) {
-		wcout << "Couldn't read limits file: " << limits_file_path << endl;
-		exit(1);
-	}
-	locale loc("");
-	inf.imbue(loc);
-	while (inf) {
-		// use wstring for wider char encodings (e.g. micro symbol)
-		wstring strInp;
-		// read line
-		getline(inf, strInp);
+	LimitsIndex limits_struct;	// final structure to store all limits, one record per parameter
+	TraceSpan span(this->tracer, L"read", L"read_limits_file");
+	span.arg(L"file", limits_file_path);
+
+	// compiled limits of an unchanged limits file, they don't depend on any configuration
+	string payload;
+	if (this->conversion_cache != nullptr && this->conversion_cache->load(L"limits", limits_file_path, 0, payload)) {
+		CacheReader in(payload, this->string_pool);
+		vector<LimitRecord> records;
+		in.get(records);
+		if (in.good()) {
+			for (LimitRecord& record : records) {
+				limits_struct.add(move(record));
+			}
+			span.counter(L"limits", limits_struct.size());
+			span.counter(L"cached", 1);
+			return limits_struct;
+		}
+	}
+
+	CacheFileState limits_state = ConversionCache::file_state(limits_file_path);
+	LineReader inf;
+	if (!inf.open(limits_file_path, &limits_state.content)) {
+		*this->log_stream << "Couldn't read limits file: " << limits_file_path << endl;
+		throw runtime_error("couldn't read limits file " + LineReader::encode(limits_file_path));
+	}
+	string_view raw_line;
+	// use wstring for wider char encodings (e.g. micro symbol)
+	wstring strInp;
+	while (inf.next_line(raw_line)) {
+		LineReader::decode(raw_line, strInp);
 		// lines containing 'key' are header lines
 		if (strInp.find(L"key") != wstring::npos) {
 			// get array of keys
@@ -77,16 +94,64 @@ map <wstring, map <wstring, wstring>> CSVReader::read_limits_file(const wstring&
 				}
 				limit_struct[L"Description"] = limit_struct[L"Description"] + L" " + limits_arr[i];
 			}
-			// add current limit_struct to final limits_struct give parameter_name as key
-			limits_struct[limits_arr[0]] = limit_struct;
+			// add compiled limit_struct to final limits_struct, a later line of the same parameter replaces it
+			LimitRecord limit;
+			this->compile_limit(limits_arr[0], limit_struct, limit);
+			limits_struct.add(move(limit));
 		}
 	}
+	span.counter(L"limits", limits_struct.size());
+	span.counter(L"cached", 0);
+
+	if (this->conversion_cache != nullptr) {
+		CacheWriter out;
+		out.put(limits_struct.get_records());
+		this->conversion_cache->store(L"limits", limits_file_path, 0, limits_state, out.get_data());
+	}
 
 	return limits_struct;
 }
 
-bool CSVReader::csvs_to_json(vector<wstring> csv_files, map<wstring, map<wstring, wstring>> limits_struct, map<wstring, wstring> configs_struct, \
+void CSVReader::compile_limit(const wstring& name, map<wstring, wstring>& limit_struct, LimitRecord& limit) {
+	limit.name = name;
+	limit.test_number = limit_struct[L"TestNr"];
+	try {
+		limit.test_number_value = stoi(limit.test_number);
+		limit.has_test_number_value = true;
+	}
+	catch (exception &e) {
+		limit.has_test_number_value = false;
+	}
+	limit.raw_unit = limit_struct[L"Unit"];
+	limit.unit = LineReader::encode(limit.raw_unit);
+	// get_unit_scale throws on invalid units, so they are only resolved when a parameter with the unit is written
+	limit.unit_valid = limit.raw_unit.empty() || (limit.raw_unit[0] != ']' && limit.raw_unit[0] != '[');
+	if (limit.unit_valid) {
+		wstring unit;
+		tie(limit.scale, unit) = this->get_unit_scale(limit.raw_unit);
+		limit.unit = LineReader::encode(unit);
+		NumericScaler::scale(limit.scale, limit_struct[L"LSL"], limit.lower_limit);
+		NumericScaler::scale(limit.scale, limit_struct[L"USL"], limit.upper_limit);
+		// numbers without unit prefix, parsed from the scaled text so they are rounded the same way
+		auto to_number = [&](const wstring& raw_value) {
+			if (raw_value.empty() || raw_value.find(L"NaN") == 0) {
+				return (double)NAN;
+			}
+			return wcstod(this->scale_value(limit.scale, raw_value).c_str(), nullptr);
+		};
+		limit.lower_limit_value = to_number(limit_struct[L"LSL"]);
+		limit.upper_limit_value = to_number(limit_struct[L"USL"]);
+		limit.typical_value = to_number(limit_struct[L"Typ"]);
+	}
+	limit.typical = limit_struct[L"Typ"];
+	limit.req_id = limit_struct[L"ReqID"];
+	limit.description = limit_struct[L"Description"];
+}
+
+bool CSVReader::csvs_to_json(vector<wstring> csv_files, const LimitsIndex& limits_struct, map<wstring, wstring> configs_struct, \
 							wstring out_folder_path, vector<wstring> png_files, vector<wstring> mat_files) {
+	TraceSpan span(this->tracer, L"convert", L"csvs_to_json");
+	span.counter(L"files", csv_files.size());
 	// define header struct
 	map<wstring, wstring> header_struct;
 	header_struct[L"version"] = L"1.0.1";
@@ -97,43 +162,33 @@ bool CSVReader::csvs_to_json(vector<wstring> csv_files, map<wstring, map<wstring
 	bool common_meta_was_created = false;
 	// define data_objects as array of maps
 	// map<wstring, map<wstring, map<wstring, wstring>>> data_objects;
-	vector<map<wstring, map<wstring, wstring>>> data_objects;
+	vector<DataObject> data_objects;
 
 	// define structure to keep repeated condition data for output
-	map<wstring, map<wstring, vector<int>>> repeated_conds;
+	// lines per file for each cond_str, in order of first occurrence
+	vector<map<wstring, vector<int>>> repeated_conds;
+	ConditionIndex repeated_cond_groups;
 	bool cond_repetition = false;
 
 	// define structure to keep lines which have data not corresponding to any column header
 	map<wstring, vector<int>> no_col_match_lines;
 
-	// define meta data variables
-	wstring username = L"";
-	wstring product_sales_code = L"";
-	wstring basic_type = L"";
-	wstring product_design_step = L"";
-	wstring package = L"";
-	wstring dut_id = L"";
+	// define limit meta data variables
 	wstring req_id = L"";
 	wstring description = L"";
 	wstring typical = L"";
-	wstring test_number = L"";
-	wstring api_id = L"";
-	wstring global_id = L"";
-	wstring test_program_name = L"";
-	wstring testunit_version = L"";
-	vector <wstring> column_types;
-	vector <wstring> variables;
-	vector <wstring> units;
-	vector <wstring> usl;
-	vector <wstring> lsl;
-	vector <wstring> test_data;
+	string test_number = "";
 	vector <wstring> no_limit_match;
 
-	// define struct to store unique out paramters(e.g.uniq('ibat_stb') = dummy_test_number)
-	// if there is no limit specified then test number will be added in increasing order for each
-	// unique parameter.
-	map <wstring, int> unique_params;
-	int test_number_counter = 1;
+	// test number of each unique out parameter (e.g. ibat_stb = 3). if there is no limit specified then test number
+	// will be added in increasing order for each unique parameter, numbers of the limits file are never used for them
+	TestNumberRegistry unique_params;
+	unique_params.reserve(limits_struct);
+	// 'TestNumbers: 1' keeps numbers of parameters without limits in 50_Report\test_numbers.txt for the next runs
+	if (configs_struct[L"TestNumbers"] == L"1") {
+		wstring report_folder = out_folder_path.substr(0, out_folder_path.find_last_of(L"\\"));
+		unique_params.use_store(report_folder + L"\\test_numbers.txt");
+	}
 
 	/*
 	cout << "PNG files: " << endl;
@@ -142,561 +197,289 @@ bool CSVReader::csvs_to_json(vector<wstring> csv_files, map<wstring, map<wstring
 	}
 	*/
 
+	// number of csv files parsed in parallel, 0 uses all cores, not used with a shared thread pool
+	int num_threads = 0;
+	try {
+		num_threads = max(0, stoi(configs_struct[L"Threads"]));
+	}
+	catch (exception &e) {
+		num_threads = 0;
+	}
+
+	// png and mat file paths are prepared once for all csv files, unless the caller keeps them prepared
+	bool use_prebuilt_index = this->prebuilt_png_index != nullptr && this->prebuilt_mat_index != nullptr;
+	MediaIndex own_png_index;
+	MediaIndex own_mat_index;
+	if (!use_prebuilt_index) {
+		TraceSpan media_span(this->tracer, L"parse", L"media_index");
+		media_span.counter(L"png_files", png_files.size());
+		media_span.counter(L"mat_files", mat_files.size());
+		this->build_media_index(png_files, own_png_index);
+		this->build_media_index(mat_files, own_mat_index);
+	}
+	const MediaIndex& png_index = use_prebuilt_index ? *this->prebuilt_png_index : own_png_index;
+	const MediaIndex& mat_index = use_prebuilt_index ? *this->prebuilt_mat_index : own_mat_index;
+
+	// parse all files in parallel, assuming that nothing is carried over from a previous file.
+	// workers only read parse_configs, png_index and mat_index
+	const map<wstring, wstring> parse_configs = configs_struct;
+	// cached results of unchanged files are valid as long as configurations and the png/mat files they can match are the same (hash_media)
+	uint64_t cache_settings_hash = ConversionCache::hash_configs(parse_configs);
+	const CSVCarryState empty_state;
+	vector<CSVFileResult> results(csv_files.size());
+	vector<bool> parsed(csv_files.size(), false);
+	mutex results_mutex;
+	// files go to the shared pool if there is one, e.g. in batch mode together with the files of other folders
+	unique_ptr<ThreadPool> own_pool;
+	ThreadPool* pool = this->thread_pool;
+	if (pool == nullptr) {
+		own_pool.reset(new ThreadPool(num_threads));
+		pool = own_pool.get();
+	}
+	TaskGroup parse_tasks(*pool);
+	for (size_t i = 0; i < csv_files.size(); i++) {
+		parse_tasks.run([&, i]() {
+			wostringstream file_log;
+			TraceSpan file_span(this->tracer, L"parse", L"parse_csv_file");
+			file_span.arg(L"file", csv_files[i]);
+			try {
+				CSVReader worker;
+				worker.set_log_stream(&file_log);
+				worker.set_string_pool(this->string_pool);
+				worker.set_conversion_cache(this->conversion_cache);
+				bool cached = worker.load_cached_result(L"csv", csv_files[i], cache_settings_hash, png_index, mat_index, results[i]);
+				if (!cached) {
+					worker.parse_csv_file(csv_files[i], empty_state, parse_configs, png_index, mat_index, results[i]);
+					results[i].log = file_log.str();
+					worker.store_cached_result(L"csv", csv_files[i], cache_settings_hash, png_index, mat_index, results[i]);
+				}
+				this->trace_file_result(file_span, results[i], cached);
+			}
+			catch (...) {
+				// reported by the merge after the log of the file, the other files are still parsed
+				results[i].error = current_exception();
+				results[i].log = file_log.str();
+			}
+			lock_guard<mutex> lock(results_mutex);
+			parsed[i] = true;
+		});
+	}
+
+	// merge results in file order. test numbers, limits and common_meta_data depend on everything
+	// before, so they are assigned here exactly like a serial run would do
+	TraceSpan merge_span(this->tracer, L"merge", L"merge_csv_files");
+	CSVCarryState carry_state;
 	for (int i = 0; i < csv_files.size(); i++) {
-		// iteratre through each csv file
-		// represents temp structure, where each fieldname is wstring combining
-		// unique conditions(e.g. "{cond_vio}{cond_vbat}")
-		// internal_json = struct();
-		map <wstring, map<wstring, map<wstring, wstring>>> internal_json;
-
-		// keep count of lines in file
-		int line_count = 0;
-
-		// get parent folder name for png match
-		wstring curr_file = csv_files[i];
-		wstring parent_folder = curr_file.substr(0, curr_file.find_last_of(L"\\") + 1);
-		// wcout << "Parent folder: " << parent_folder << endl;
-		// conditions that will help to match corresponding png and .mat files for raw_data_link and waveform links
-		vector<wstring> file_match_conditions;
-		// add first png file match condition to png_file_match_conditions
-		file_match_conditions.push_back(parent_folder);
-
-		// start reading file
-		wifstream inf(csv_files[i]);
-		if (!inf) {
-			wcout << L"Couldn't read csv file: " << csv_files[i] << endl;
+		// on a worker of a shared pool other files are parsed meanwhile
+		pool->run_until([&]() {
+			lock_guard<mutex> lock(results_mutex);
+			return parsed[i];
+		});
+		CSVFileResult& result = results[i];
+
+		// file used values of a previous file (e.g. no #meta line), parse again with the real carried over values
+		if (!result.error && result.opened && (result.inherited_reads & this->carry_differences(carry_state, empty_state)) != 0) {
+			result = CSVFileResult();
+			wostringstream file_log;
+			TraceSpan file_span(this->tracer, L"parse", L"parse_csv_file (carried over)");
+			file_span.arg(L"file", csv_files[i]);
+			CSVReader worker;
+			worker.set_log_stream(&file_log);
+			worker.set_string_pool(this->string_pool);
+			worker.set_conversion_cache(this->conversion_cache);
+			// cached separately from the result with an empty carry state, valid for the same carried over values only
+			uint64_t carried_settings_hash = this->hash_carry_state(carry_state, cache_settings_hash);
+			try {
+				bool cached = worker.load_cached_result(L"csv_carried", csv_files[i], carried_settings_hash, png_index, mat_index, result);
+				if (!cached) {
+					worker.parse_csv_file(csv_files[i], carry_state, parse_configs, png_index, mat_index, result);
+					result.log = file_log.str();
+					worker.store_cached_result(L"csv_carried", csv_files[i], carried_settings_hash, png_index, mat_index, result);
+				}
+				this->trace_file_result(file_span, result, cached);
+			}
+			catch (...) {
+				result.error = current_exception();
+				result.log = file_log.str();
+			}
+		}
+
+		*this->log_stream << result.log;
+		if (result.error) {
+			rethrow_exception(result.error);
+		}
+		if (!result.opened) {
 			break;
 		}
-		locale loc("");
-		inf.imbue(loc);
-
-		// get name of the folder containing csv file -> test_program_name
-		test_program_name = csv_files[i].substr(0, csv_files[i].find_last_of(L"\\"));
-		test_program_name = test_program_name.substr(test_program_name.find_last_of(L"\\") + 1, test_program_name.size() - 1);
-
-		wcout << L"Reading csv: " << csv_files[i] << endl << endl;
-		// for manual measurement meta data is coming from configs_struct
-		if (!configs_struct[L"user"].empty()) {
-			username = configs_struct[L"user"];
-		}
-		if (!configs_struct[L"product_sales_code"].empty()) {
-			product_sales_code = configs_struct[L"product_sales_code"];
-		}
-		if (!configs_struct[L"basic_type"].empty()) {
-			basic_type = configs_struct[L"basic_type"];
-		}
-		if (!configs_struct[L"product_design_step"].empty()) {
-			product_design_step = configs_struct[L"product_design_step"];
-		}
-		if (!configs_struct[L"package"].empty()) {
-			package = configs_struct[L"package"];
-		}
-		if (!configs_struct[L"dut_id"].empty()) {
-			dut_id = configs_struct[L"dut_id"];
-		}
-		if (!configs_struct[L"api_id"].empty()) {
-			api_id = configs_struct[L"api_id"];
-		}
-		if (!configs_struct[L"global_id"].empty()) {
-			global_id = configs_struct[L"global_id"];
-		}
-		if (!configs_struct[L"testunit_version"].empty()) {
-			testunit_version = configs_struct[L"testunit_version"];
-		}
-
-		if (!common_meta_was_created && basic_type != L"" && product_sales_code != L"" && product_design_step != L"") {
-			common_meta_data = this->construct_common_meta_data(basic_type, product_design_step, product_sales_code, username, configs_struct[L"Email"]);
-			common_meta_was_created = true;
-		}
-		
-		while (inf) {
-			wstring strInp;
-			// read line
-			getline(inf, strInp);
-			line_count++;
-			if (strInp.find(L"#meta") != wstring::npos) {
-				// read meta for following data lines
-				// some csvs have format basic_type : S1234, some have format
-				// basic_type, S1234.Converting all formats to latter one
-				strInp = this->strrep(strInp, ':', ',');
-				// replace ; with , (Bucharest data)
-				strInp = this->strrep(strInp, ';', ',');
-
-				// separate #meta lines on ,
-				vector <wstring> line_data = this->strsplit(strInp, L",");
-
-				// iterate through each meta word chunk(key, value)
-				// if the keyword is found in chunk, then value is in next chunk, so
-				// setting index to next counter
-				for (int counter = 0; counter < line_data.size(); counter++) {
-					if (line_data[counter].find(L"user") != wstring::npos && line_data[counter].find(L"email") == wstring::npos) {
-						// if username is not set in configs read from CSV
-						if (configs_struct[L"Username"].empty()) {
-							username = line_data[counter + 1];
-							username = this->strtrim(username);
-						}
-						else {
-							username = configs_struct[L"Username"];
-						}
-					}
-					else if (line_data[counter].find(L"product_sales_code") != wstring::npos) {
-						product_sales_code = line_data[counter + 1];
-						product_sales_code = this->strtrim(product_sales_code);
-					}
-					else if (line_data[counter].find(L"basic_type") != wstring::npos) {
-						basic_type = line_data[counter + 1];
-						basic_type = this->strtrim(basic_type);
-					}
-					else if (line_data[counter].find(L"product_design_step") != wstring::npos) {
-						product_design_step = line_data[counter + 1];
-						product_design_step = this->strtrim(product_design_step);
-					}
-					else if (line_data[counter].find(L"package") != wstring::npos) {
-						package = line_data[counter + 1];
-						package = this->strtrim(package);
-					}
-					else if (line_data[counter].find(L"dut_id") != wstring::npos) {					
-						dut_id = line_data[counter + 1];
-						dut_id = this->strtrim(dut_id);
-						// clear previous dut_id condition if there was any
-						while (file_match_conditions.size() > 1) {
-							file_match_conditions.pop_back();
-						}
-						// add as sample={dut_id} to png conditions match list
-						file_match_conditions.push_back(L"sample=" + dut_id);
-					}
-					else if (line_data[counter].find(L"api_id") != wstring::npos) {
-						api_id = line_data[counter + 1];
-						api_id = this->strtrim(api_id);
-					}
-					else if (line_data[counter].find(L"global_id") != wstring::npos) {
-						global_id = line_data[counter + 1];
-						global_id = this->strtrim(global_id);
-					}
-					else if (line_data[counter].find(L"testunit_version") != wstring::npos) {
-						testunit_version = line_data[counter + 1];
-						testunit_version = this->strtrim(testunit_version);
-					}
-				}
-				if (!common_meta_was_created && basic_type != L"" && product_sales_code != L"" && product_design_step != L"") {
-					common_meta_data = this->construct_common_meta_data(basic_type, product_design_step, product_sales_code, username, configs_struct[L"Email"]);
-					common_meta_was_created = true;
-				}
+
+		// values which were not set by current file stay for the next one
+		for (int v = 0; v < NUM_CARRY_VALUES; v++) {
+			if (result.assigned_fields & carry_value_bit(v)) {
+				carry_state.values[v] = result.end_state.values[v];
+			}
+		}
+		for (int r = 0; r < NUM_CARRY_ROWS; r++) {
+			if (result.assigned_fields & carry_row_bit(r)) {
+				carry_state.rows[r] = result.end_state.rows[r];
+			}
+		}
+
+		// replay out values in file order to assign test numbers and limits
+		vector<string> cell_test_numbers(result.out_cells.size());
+		for (size_t cell = 0; cell <= result.out_cells.size(); cell++) {
+			if (!common_meta_was_created && result.has_common_meta && result.common_meta_position == cell) {
+				common_meta_data = this->construct_common_meta_data(result.common_meta_basic_type, result.common_meta_product_design_step,
+					result.common_meta_product_sales_code, result.common_meta_username, configs_struct[L"Email"]);
+				common_meta_was_created = true;
+			}
+			if (cell == result.out_cells.size()) {
+				break;
+			}
+			const CSVOutCell& out_cell = result.out_cells[cell];
+			const wstring& key_name = out_cell.key_name;
+			int scale{};
+			wstring unit{};
+
+			// add test number from limits if it exists, otherwise hardcode
+			const LimitRecord* limit = limits_struct.find(key_name);
+			int unique_number = 0;
+			bool is_unique_param = !unique_params.find(key_name, unique_number);
+			if (limit != nullptr) {
+				// get test number from limits
+				LineReader::encode(limit->test_number, cell_test_numbers[cell]);
+			}
+			else if (!is_unique_param) {
+				// use already assigned test number
+				cell_test_numbers[cell] = to_string(unique_number);
 			}
 			else {
-				// reading other than #meta lines
-				// replace , with ; (Buch data)
-				strInp = this->strrep(strInp, ',', ';');
-				// separate test data line on ;
-				vector <wstring> line_data = this->strsplit(strInp, L";", false);
-				// to check for empty csv files, if columns are less than 3 skip them
-				// less than 3, because sometimes it can contains dummy values
-				if (line_data.size() < 3) {
-					continue;
-				}
-				// check type of line (col types, var names, units or test data)
-				if (strInp.find(L"Columns type") != wstring::npos) {
-					column_types = line_data;
-					// iterate through column types, if any is empty report to user
-					for (int i = 0; i < column_types.size(); i++) {
-						if (column_types[i].empty()) {
-							wstring col_name = this->get_excel_col_name(i+1);
-							wcout << L"WARNING: Empty entry for Column Types at " << to_wstring(line_count) + col_name << L". Column "
-								<< col_name << L" will be skipped!" << endl;
-						}
-					}
-				}
-				else if (strInp.find(L"Variables") != wstring::npos) {
-					variables = line_data;
-					// iterate through param names, if any is empty report to user 
-					for (int i = 0; i < variables.size(); i++) {
-						if (variables[i].empty()) {
-							wstring col_name = this->get_excel_col_name(i+1);
-							wcout << L"WARNING: Empty entry for Variables at " << to_wstring(line_count) + col_name << L". Column "
-								<< col_name << L" will be skipped!" << endl;
-						}
-					}
-				}
-				else if (strInp.find(L"Units") != wstring::npos) {
-					units = line_data;
-				}
-				else if (strInp.find(L"LSL") != wstring::npos) {
-					lsl = line_data;
-				}
-				else if (strInp.find(L"USL") != wstring::npos) {
-					usl = line_data;
-				}
-				else if (strInp[0] == '#' || all_of(line_data.begin(), line_data.end(), [](wstring elem) { return elem.compare(L"") == 0; })) {
-					// skip all other rows starting with # or having empty vals
+				// assign a new unique test number, every number after the first one leaves a gap
+				unique_number = unique_params.allocate(key_name, !unique_params.empty(), true);
+				cell_test_numbers[cell] = to_string(unique_number);
+			}
+
+			// check if current parameter is not in unique_params,
+			// add a limit for it
+			if (is_unique_param) {
+				// parameters with limit rows in the csv file get a counted number for their limit object, even if they are in the limits file
+				if (limit != nullptr && out_cell.has_limit_rows) {
+					unique_number = unique_params.allocate(key_name, false, false);
 				}
-				else {
-					// if none of the above, then it's a test data
-					test_data = line_data;
-					// key_name wstring (e.g. conv_VIO)
-					wstring key_name = L"";
-					// init meta data struct to construct meta_data
-					map <wstring, wstring> meta_data;
-					// wstring containing combination of conditions
-					wstring cond_str = L"";
-					wstring key_cond_str = L"";
-					int scale{};
-					wstring unit{};
-					wstring scaled_value{};
-					vector<wstring> comments{};
-					vector<wstring> pic_path{};
-					vector<wstring> wfm_path{};
-					// iterate through each column in current row to build meta_data
-					for (int current_col = 0; current_col < test_data.size(); current_col++) {
-						// check if current data value doesn't correspond to any column header
-						if (current_col >= column_types.size()) {
-							// save line number to report the error
-							no_col_match_lines[csv_files[i]].push_back(line_count);
-							continue;
-						}
-						// check if param name is not present skip column
-						if (variables[current_col].empty()) {
-							continue;
-						}
-						// check if current column corresponds to parameter
-						if (column_types[current_col].compare(L"param") == 0) {
-							// construct meta_data key name (e.g. conv_VIO)
-							key_name = L"cond_" + variables[current_col];
-							// handle special cases
-							if (this->convert_to_lower(key_name).compare(L"cond_temp") == 0) {
-								key_name = L"cond_tambient";
-								// if temperature is empty, make it 0
-								if (test_data[current_col].empty()) {
-									wcout << L"TEMP IS EMPTY AT " << line_count << endl;
-									test_data[current_col] = L"0";
-								}
-							}
-							else if (key_name.compare(L"cond_vio") == 0) {
-								key_name = L"cond_VIO";
-							}
-							// combine conditions
-							cond_str = cond_str + L"_" + test_data[current_col];
-							cond_str = cond_str + username + L"_" + basic_type + L"_" + product_sales_code + L"_" + product_design_step + L"_" +
-								package + L"_" + dut_id;
-							meta_data[key_name] = test_data[current_col];
-							// add each condition to the png_file_match_conditions with values. add [ as end of condition (e.g. vio=3[V])
-							file_match_conditions.push_back(variables[current_col] + L"=" + test_data[current_col] + L"[");
-						}
-						// check if current column corresponds to comment, and variable is picture path
-						if (this->convert_to_lower(column_types[current_col]).find(L"comment") != wstring::npos && variables[current_col] != L"PicturePath" &&
-							!test_data[current_col].empty()) {
-							comments.push_back(test_data[current_col]);
-						}
-					}
-					// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-					// iterate through each column in current row to build picture path
-					for (int current_col = 0; current_col < test_data.size(); current_col++) {
-						if (this->convert_to_lower(column_types[current_col]).find(L"comment") != wstring::npos && variables[current_col] == L"PicturePath" &&
-							!test_data[current_col].empty()) {
-							pic_path.push_back(test_data[current_col]);
-						}
-					}
-					for (int current_col = 0; current_col < test_data.size(); current_col++) {
-						if (this->convert_to_lower(column_types[current_col]).find(L"comment") != wstring::npos && variables[current_col] == L"WaveformPath" &&
-							!test_data[current_col].empty()) {
-							wfm_path.push_back(test_data[current_col]);
-						}
-					}
-					// +++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-					// get cond_link as path to the folder containing current CSV file
-					meta_data[L"cond_link_screenshots"] = L"file:///" + this->strrep(csv_files[i].substr(0, csv_files[i].find_last_of(L"\\")), '\\', '/');
-					meta_data[L"cond_link_raw_data"] = L"file:///" + this->strrep(csv_files[i].substr(0, csv_files[i].find_last_of(L"\\")), '\\', '/');
-					// get cond_link_waveforms
-					int matching_mat_files_count = 0;
-					wstring matching_mat_filename{};
-					for (auto mat_file: mat_files) {
-						// if there are multiple .mat files for the current parent folder name 
-						// get them based on conditions match
-						if (mat_file.find(parent_folder) != wstring::npos) {
-							matching_mat_files_count++;
-						}
-					}
-					/*
-					// FOR CONSTRUCTING BASED ON THE SPECIFIC FILENAME FOR MAT EXPLORER TOOL
-					vector<wstring> matching_mat_files{};
-					if (matching_mat_files_count > 1) {
-						matching_mat_files = get_corresponding_files(file_match_conditions, mat_files);
-						// there is only one mat file per condition combination
-						if (matching_mat_files.size() > 0) {
-							matching_mat_filename = matching_mat_files[0];
-						}
-					}
-					else if (matching_mat_files_count == 1) {
-						// only one mat file, matching is done based on parent folder name
-						for (auto mat_file : mat_files) {
-							if (mat_file.find(parent_folder) != wstring::npos) {
-								matching_mat_filename = mat_file;
-							}
-						}
+				// create a data object for current limit
+				DataObject limit_data_object;
+				if (out_cell.has_csv_limits) {
+					// get scale, unit
+					tie(scale, unit) = this->get_unit_scale(out_cell.unit);
+					// hardcode scale 0, because tembo does auto conversion
+					limit_data_object.scale = "NA";
+					LineReader::encode(unit, limit_data_object.unit);
+
+					// deal with no limits: NaN
+					// get lower limit
+					if (out_cell.lsl.find(L"NaN")==0) {
+						limit_data_object.lower_limit = "";
 					}
-					*/
-					// since for now we use only folder name, it doesn't matter how many files matched. All of them are in the same folder
-					for (auto mat_file : mat_files) {
-						if (mat_file.find(parent_folder) != wstring::npos) {
-							matching_mat_filename = mat_file;
-							break;
-						}
+					else {
+						NumericScaler::scale(scale, out_cell.lsl, limit_data_object.lower_limit);
 					}
-					// constuct proper cond_link_waveforms if matching mat file was found
-					if (!matching_mat_filename.empty()) {
-						// TODO: uncomment this for cond_link_waveforms
-						// meta_data[L"cond_link_waveforms"] = L"file:///" + waveform_explorer_path + L" /k " + matching_mat_filename;
-						// meta_data[L"cond_link_waveforms"] = strrep(meta_data[L"cond_link_waveforms"], '\\', '/');
-						meta_data[L"cond_link_waveforms"] = L"file:///" + this->strrep(matching_mat_filename.substr(0, matching_mat_filename.find_last_of(L"\\")), '\\', '/');
+					// get upper limit scaled value
+					if (out_cell.usl.find(L"NaN")==0) {
+						limit_data_object.upper_limit = "";
 					}
-					// wcout << meta_data[L"cond_link_waveforms"] << endl;
-
-					repeated_conds[cond_str][csv_files[i]].push_back(line_count);
-					// iterate through each col again and for each out param
-					// construct dataObject with payload + meta_data
-					for (int current_col = 0; current_col < test_data.size(); current_col++) {
-						// check if current data value doesn't correspond to any column header
-						if (current_col >= column_types.size()) {
-							continue;
-						}
-						// check if param name is not present skip column
-						if (variables[current_col].empty()) {
-							continue;
-						}
-						if (column_types[current_col].compare(L"out") == 0) {
-							// skip if empty
-							if (test_data[current_col].empty()) {
-								continue;
-							}
-							// init structre to keep payload
-							map <wstring, wstring> payload;
-							// construct key_name from variables row, e.g. ibat_stb
-							key_name = variables[current_col];
-							// validate key_name
-							key_name = this->validate_param_name(key_name);
-							// add out param name to keep param conds str separately
-							key_cond_str = key_name + cond_str;
-							
-							// add current key_cond_str to repeated cond (to save first occurrence)
-							// scale according to unit
-							tie(scale, unit) = this->get_unit_scale(units[current_col]);
-							scaled_value = this->scale_value(scale, test_data[current_col]);
-							payload[key_name] = scaled_value;
-							
-							// if there are matching png files save them to payload + pic_path
-							// upadte 22.12.2021 matching is also based on pic_path
-							file_match_conditions.push_back(L"Report-Picture");
-							vector<wstring> matching_png_files = get_corresponding_files(file_match_conditions, png_files, pic_path);
-							file_match_conditions.pop_back();
-							
-							// save related png files to current payload
-							for (auto i = 0; i < matching_png_files.size(); i++) {
-								payload[L"png_filename___" + to_wstring(i)] = strrep(matching_png_files[i], '\\', '/');
-							}
-							// save related comments
-							for (auto i = 0; i < comments.size(); i++) {
-								payload[L"comment___" + to_wstring(i)] = comments[i];
-							}
-							// get corresponding .mat files
-							file_match_conditions.push_back(L"Report-waveform");
-							vector<wstring> matching_mat_files = get_corresponding_files(file_match_conditions, mat_files, wfm_path);
-							file_match_conditions.pop_back();
-							// save related .mat files
-							for (auto i = 0; i < matching_mat_files.size(); i++) {
-								payload[L"mat_filename___" + to_wstring(i)] = strrep(matching_mat_files[i], '\\', '/');
-							}
-							// add other meta fields
-							meta_data[L"test_name"] = key_name;
-							meta_data[L"data_object_type"] = L"value";
-							meta_data[L"dut_id"] = dut_id;
-							meta_data[L"package"] = package;
-							meta_data[L"user_name"] = username;
-							// add rddf_tc_id only if api_id and global_id are set
-							if (!api_id.empty() && !global_id.empty()) {
-								meta_data[L"rddf_tc_id"] = api_id + L":" + global_id;
-							}
-							meta_data[L"test_program_name"] = test_program_name;
-							meta_data[L"test_program_revision"] = testunit_version;
-
-							// add test number from limits if it exists, otherwise hardcode
-							if (limits_struct.find(key_name) != limits_struct.end()) {
-								// get test number from limits
-								meta_data[L"test_number"] = limits_struct[key_name][L"TestNr"];
-							}
-							else {
-								// if limit doesn't exist, check if hardcoded test number already exists
-								if (unique_params.find(key_name) != unique_params.end()) {
-									// use already assigned test number
-									meta_data[L"test_number"] = to_wstring(unique_params[key_name]);
-								}
-								else if (unique_params.empty()) {
-									// first unique parameter. Add test number manually and increment test_number_counter
-									meta_data[L"test_number"] = to_wstring(test_number_counter);
-								}
-								else {
-									// otherwise assign a new unique test number
-									// by incrementing test_counter while uniqueness is achieved
-									// to avoid overlap with test numbers from limits file
-									bool found_unique = false;
-									while (!found_unique) {
-										for (map <wstring, int>::value_type& unique_param : unique_params) {
-											if (unique_param.second == test_number_counter) {
-												found_unique = false;
-												break;
-											}
-											else {
-												found_unique = true;
-											}
-										}
-										test_number_counter++;
-									}
-									meta_data[L"test_number"] = to_wstring(test_number_counter);
-								}
-							}
-
-							// create dataObject for current out value with payload and meta_data
-							map <wstring, map<wstring, wstring>> data_object;
-							data_object[L"payload"] = payload;
-							data_object[L"metaData"] = meta_data;
-							
-							// if key_cond_str is already in internal_json, condition repetition occurred
-							// mark flag true to inform user
-							if (internal_json.find(key_cond_str) != internal_json.end()) {
-								cond_repetition = true;
-							}
-							
-							// store current metaData and payload in internal_json
-							internal_json[key_cond_str] = data_object;
-							// check if current parameter is not in unique_params,
-							// add a limit for it
-							if (unique_params.find(key_name) == unique_params.end()) {
-								// create a payload for current limit
-								map <wstring, wstring> limit_payload;
-								// create a meta_data for current limit
-								map <wstring, wstring> limit_meta_data;
-								// define limit_struct to store single limit structure
-								map<wstring, wstring> limit_struct;
-								if (!lsl.empty() && !usl.empty() && !lsl[current_col].empty() && !usl[current_col].empty() 
-											&& current_col < lsl.size() && current_col < usl.size()) {
-									// get scale, unit
-									tie(scale, unit) = this->get_unit_scale(units[current_col]);
-									// hardcode scale 0, because tembo does auto conversion
-									limit_payload[L"scale"] = L"NA";
-									limit_payload[L"unit"] = unit;
-
-									// deal with no limits: NaN
-									// get lower limit
-									if (lsl.at(current_col).find(L"NaN")==0) {
-										limit_payload[L"lower_limit"] = L"";
-									}
-									else {
-										scaled_value = this->scale_value(scale, lsl[current_col]);
-										limit_payload[L"lower_limit"] = scaled_value;
-									}
-									// get upper limit scaled value
-									if (usl.at(current_col).find(L"NaN")==0) {
-										limit_payload[L"upper_limit"] = L"";
-									}
-									else {
-										scaled_value = this->scale_value(scale, usl[current_col]);
-										limit_payload[L"upper_limit"] = scaled_value;
-									}
-
-									req_id = L"";
-									description = L"";
-									typical = L"";
-									test_number = to_wstring(test_number_counter);
-									// wcout << L"Getting from USL: " << usl[current_col] << endl;
-								}
-								else if (limits_struct.find(key_name) != limits_struct.end()) {
-									// get the current limit structure
-									for (map<wstring, map<wstring, wstring>>::value_type& iter : limits_struct) {
-										if (iter.first == key_name) {
-											for (map<wstring, wstring>::value_type& iter_obj : iter.second) {
-												limit_struct[iter_obj.first] = iter_obj.second;
-											}
-										}
-									}
-									
-									// get scale, unit
-									tie(scale, unit) = this->get_unit_scale(limit_struct[L"Unit"]);
-									// hardcode scale 0, because tembo does auto conversion
-									limit_payload[L"scale"] = L"NA";
-									limit_payload[L"unit"] = unit;
-
-									// get lower limit
-									scaled_value = this->scale_value(scale, limit_struct[L"LSL"]);
-									limit_payload[L"lower_limit"] = scaled_value;
-
-									// get upper limit scaled value
-									scaled_value = this->scale_value(scale, limit_struct[L"USL"]);
-									limit_payload[L"upper_limit"] = scaled_value;
-
-									// add meta data from limit struct
-									req_id = limit_struct[L"ReqID"];
-									description = limit_struct[L"Description"];
-									typical = limit_struct[L"Typ"];
-									test_number = limit_struct[L"TestNr"];
-								}
-								else {
-									// use hardcoded limits
-									// get scale and unit
-									tie(scale, unit) = this->get_unit_scale(units[current_col]);
-									limit_payload[L"unit"] = unit;
-									// hardcode scale to 0, because tembo does auto conversion
-									limit_payload[L"scale"] = L"NA";
-
-									// get upper limit
-									// limit_payload["upper_limit"] = generate_limit_from_test_value(payload[key_name], true);
-
-									// get lower limit
-									// limit_payload["lower_limit"] = generate_limit_from_test_value(payload[key_name], false);
-
-									// Back to empty limits
-									limit_payload[L"upper_limit"] = L"";
-									limit_payload[L"lower_limit"] = L"";
-
-									req_id = L"";
-									description = L"";
-									typical = L"";
-									test_number = to_wstring(test_number_counter);
-									// save no matches in txt
-									no_limit_match.push_back(key_name);
-								}
-								// construct limit meta data
-								limit_meta_data = this->construct_limit_meta_data(common_meta_data, req_id, description, typical, test_number, key_name);
-
-								// create a data object for current limit
-								map <wstring, map<wstring, wstring>> limit_data_object;
-								limit_data_object[L"payload"] = limit_payload;
-								limit_data_object[L"metaData"] = limit_meta_data;
-
-								// add limit_data_object to data_objects
-								data_objects.push_back(limit_data_object);
-								// store unique out params to add limits
-								// check if it has defined limits or hard coded
-								if (limits_struct.find(key_name) != limits_struct.end() && usl.empty() && lsl.empty()) {
-									unique_params[key_name] = stoi(limit_struct[L"TestNr"]);
-								}
-								else {
-									unique_params[key_name] = test_number_counter++;
-								}
-							}
-						}
+					else {
+						NumericScaler::scale(scale, out_cell.usl, limit_data_object.upper_limit);
 					}
-					// clear png file match conditions (skip first two for parent folder and dut it)
-					while (file_match_conditions.size() > 2) {
-						file_match_conditions.pop_back();
+
+					req_id = L"";
+					description = L"";
+					typical = L"";
+					test_number = to_string(unique_number);
+				}
+				else if (limit != nullptr) {
+					// unit, scale and scaled limits were resolved when reading the limits file
+					if (!limit->unit_valid) {
+						// reports the invalid unit
+						this->get_unit_scale(limit->raw_unit);
 					}
+					// hardcode scale 0, because tembo does auto conversion
+					limit_data_object.scale = "NA";
+					limit_data_object.unit = limit->unit;
+					limit_data_object.lower_limit = limit->lower_limit;
+					limit_data_object.upper_limit = limit->upper_limit;
+
+					// add meta data from limit struct
+					req_id = limit->req_id;
+					description = limit->description;
+					typical = limit->typical;
+					LineReader::encode(limit->test_number, test_number);
+				}
+				else {
+					// use hardcoded limits
+					// get scale and unit
+					tie(scale, unit) = this->get_unit_scale(out_cell.unit);
+					LineReader::encode(unit, limit_data_object.unit);
+					// hardcode scale to 0, because tembo does auto conversion
+					limit_data_object.scale = "NA";
+
+					// get upper limit
+					// limit_payload["upper_limit"] = generate_limit_from_test_value(payload[key_name], true);
+
+					// get lower limit
+					// limit_payload["lower_limit"] = generate_limit_from_test_value(payload[key_name], false);
+
+					// Back to empty limits
+					limit_data_object.upper_limit = "";
+					limit_data_object.lower_limit = "";
+
+					req_id = L"";
+					description = L"";
+					typical = L"";
+					test_number = to_string(unique_number);
+					// save no matches in txt
+					no_limit_match.push_back(key_name);
+				}
+				// construct limit meta data
+				this->construct_limit_meta_data(limit_data_object, common_meta_data, req_id, description, typical, test_number, key_name);
+
+				// add limit_data_object to data_objects
+				data_objects.push_back(move(limit_data_object));
+				// store unique out params to add limits
+				// check if it has defined limits or hard coded
+				// the others were allocated above
+				if (limit != nullptr && !out_cell.has_limit_rows) {
+					unique_params.assign(key_name, limit->get_test_number_value());
 				}
 			}
-		} // finished reading current csv -> while(inf)
+		}
 
 		// since current csv is done, copy remaining internal json objects into
 		// data_objects, because new file will have different params
-		for (map <wstring, map<wstring, map<wstring, wstring>>>::value_type& data_object : internal_json) {
-			data_objects.push_back(data_object.second);
-			
+		for (auto& data_object : result.internal_json) {
+			data_object.second.test_number = cell_test_numbers[data_object.first];
+			data_objects.push_back(move(data_object.second));
+		}
+
+		// collect reports of current file
+		cond_repetition = cond_repetition || result.cond_repetition;
+		for (auto& repeated_cond : result.repeated_conds) {
+			size_t group = repeated_cond_groups.insert(repeated_cond.first, repeated_conds.size());
+			if (group == repeated_conds.size()) {
+				repeated_conds.emplace_back();
+			}
+			repeated_conds[group][csv_files[i]] = move(repeated_cond.second);
+		}
+		if (!result.no_col_match_lines.empty()) {
+			no_col_match_lines[csv_files[i]] = move(result.no_col_match_lines);
 		}
+		// release memory of merged file
+		result = CSVFileResult();
+	}
+	parse_tasks.wait();
+	merge_span.counter(L"data_objects", data_objects.size());
+	merge_span.end();
+
+	if (!unique_params.save()) {
+		*this->log_stream << L"Couldn't write test numbers of the project" << endl;
 	}
 
 	if (no_limit_match.size() > 0) {
@@ -709,7 +492,7 @@ bool CSVReader::csvs_to_json(vector<wstring> csv_files, map<wstring, map<wstring
 	}
 
 	if (no_col_match_lines.size() > 0) {
-		wcout << endl << L"WARNING: Detected values that are not correponding to any columns (values omitted)... For more details please check " << 
+		*this->log_stream << endl << L"WARNING: Detected values that are not correponding to any columns (values omitted)... For more details please check " << 
 			L"50_Report/No_Col_Match.csv" << endl << endl << endl;
 		wofstream out(out_folder_path + L"\\No_Col_Match.csv");
 		out << L"File;Lines";
@@ -722,12 +505,12 @@ bool CSVReader::csvs_to_json(vector<wstring> csv_files, map<wstring, map<wstring
 	}
 
 	if (cond_repetition) {
-		cout << L"WARNING: Repeated condition occured (saved only last occurence).. For more details please check" 
+		*this->log_stream << L"WARNING: Repeated condition occured (saved only last occurence).. For more details please check" 
 			<< L"50_Report/CSVs_repeated_conditions.csv" << endl << endl << endl;
 		wofstream out(out_folder_path + L"\\CSVs_repeated_conditions.csv");
 		out << L"File;Lines\n";
-		for (map<wstring, map<wstring, vector<int>>>::value_type& repeated_cond_str : repeated_conds) {
-			for (map<wstring, vector<int>>::value_type& repeated_cond : repeated_cond_str.second) {
+		for (map<wstring, vector<int>>& repeated_cond_str : repeated_conds) {
+			for (map<wstring, vector<int>>::value_type& repeated_cond : repeated_cond_str) {
 				if (repeated_cond.second.size() > 1) {
 					out << repeated_cond.first << L";";
 					for (auto data : repeated_cond.second) {
@@ -747,32 +530,896 @@ bool CSVReader::csvs_to_json(vector<wstring> csv_files, map<wstring, map<wstring
 	return res;
 }
 
-vector<wstring>CSVReader::get_corresponding_files(vector<wstring> file_match_conditions, vector<wstring> files, vector<wstring> pic_path) {
-	vector<wstring> matching_files{};
-	for (auto file : files) {
-		// check how many conditions are given in the current filename based on the number of '=' chars
-		// there is always should be at least 1 occurence for dut_id / sample, the rest are for conditions
-		int num_of_conds_in_filename = this->count_char_occurence(file, '=');
-		// add one more condition for matching parent folder name
-		num_of_conds_in_filename++;
+void CSVReader::build_media_index(const vector<wstring>& files, MediaIndex& index) {
+	index.files = files;
+	index.lower_files.resize(files.size());
+	index.num_conds.resize(files.size());
+	index.base_filenames.resize(files.size());
+	index.links.resize(files.size());
+	index.files_by_name.clear();
+	index.files_by_folder.clear();
+	for (size_t i = 0; i < files.size(); i++) {
+		this->prepare_media_file(index, i);
+		index.files_by_name[index.base_filenames[i]].push_back(i);
+		// register file for all folders above it (e.g. C:\a\ and C:\a\b\)
+		const wstring& file = files[i];
+		for (size_t pos = file.find(L'\\'); pos != wstring::npos; pos = file.find(L'\\', pos + 1)) {
+			auto folder = index.files_by_folder.emplace(file.substr(0, pos + 1), make_pair(i, 0));
+			folder.first->second.second++;
+		}
+	}
+}
+
+void CSVReader::prepare_media_file(MediaIndex& index, size_t i) {
+	const wstring& file = index.files[i];
+	index.lower_files[i] = this->convert_to_lower(file);
+	// check how many conditions are given in the current filename based on the number of '=' chars
+	// there is always should be at least 1 occurence for dut_id / sample, the rest are for conditions
+	// add one more condition for matching parent folder name
+	index.num_conds[i] = this->count_char_occurence(file, '=') + 1;
+	index.base_filenames[i] = file.substr(file.find_last_of(L"/\\") + 1);
+	index.links[i] = this->string_pool->intern(this->strrep(index.base_filenames[i], '\\', '/'));
+}
+
+bool CSVReader::add_media_file(const wstring& file_path, MediaIndex& index) {
+	size_t i = lower_bound(index.files.begin(), index.files.end(), file_path, InputCatalog::path_less) - index.files.begin();
+	if (i < index.files.size() && index.files[i] == file_path) {
+		return false;
+	}
+	// files after the new one move by one position
+	for (auto& named : index.files_by_name) {
+		for (size_t& file_index : named.second) {
+			if (file_index >= i) {
+				file_index++;
+			}
+		}
+	}
+	for (auto& folder : index.files_by_folder) {
+		if (folder.second.first >= i) {
+			folder.second.first++;
+		}
+	}
+	index.files.insert(index.files.begin() + i, file_path);
+	index.lower_files.insert(index.lower_files.begin() + i, wstring());
+	index.num_conds.insert(index.num_conds.begin() + i, 0);
+	index.base_filenames.insert(index.base_filenames.begin() + i, wstring());
+	index.links.insert(index.links.begin() + i, StringPool::empty());
+	this->prepare_media_file(index, i);
+
+	vector<size_t>& named = index.files_by_name[index.base_filenames[i]];
+	named.insert(lower_bound(named.begin(), named.end(), i), i);
+	for (size_t pos = file_path.find(L'\\'); pos != wstring::npos; pos = file_path.find(L'\\', pos + 1)) {
+		auto folder = index.files_by_folder.emplace(file_path.substr(0, pos + 1), make_pair(i, 0));
+		// files below a folder are next to each other in sorted order, the new one can only become the first one
+		folder.first->second.first = min(folder.first->second.first, i);
+		folder.first->second.second++;
+	}
+	return true;
+}
+
+bool CSVReader::remove_media_path(const wstring& file_path, MediaIndex& index) {
+	// removed files are next to each other in sorted order: the file itself or everything below the folder
+	wstring folder_prefix = file_path + L"\\";
+	size_t first = lower_bound(index.files.begin(), index.files.end(), file_path, InputCatalog::path_less) - index.files.begin();
+	size_t last = first;
+	if (first < index.files.size() && index.files[first] == file_path) {
+		last++;
+	}
+	else {
+		first = lower_bound(index.files.begin(), index.files.end(), folder_prefix, InputCatalog::path_less) - index.files.begin();
+		last = first;
+		while (last < index.files.size() && index.files[last].compare(0, folder_prefix.size(), folder_prefix) == 0) {
+			last++;
+		}
+	}
+	if (first == last) {
+		return false;
+	}
+	size_t num_removed = last - first;
+	for (size_t i = first; i < last; i++) {
+		const wstring& file = index.files[i];
+		auto named = index.files_by_name.find(index.base_filenames[i]);
+		named->second.erase(find(named->second.begin(), named->second.end(), i));
+		if (named->second.empty()) {
+			index.files_by_name.erase(named);
+		}
+		for (size_t pos = file.find(L'\\'); pos != wstring::npos; pos = file.find(L'\\', pos + 1)) {
+			auto folder = index.files_by_folder.find(file.substr(0, pos + 1));
+			if (--folder->second.second == 0) {
+				index.files_by_folder.erase(folder);
+			}
+		}
+	}
+	// files after the removed ones move up, the first file of a folder which kept files is the next one below it, now at first
+	for (auto& named : index.files_by_name) {
+		for (size_t& file_index : named.second) {
+			if (file_index >= last) {
+				file_index -= num_removed;
+			}
+		}
+	}
+	for (auto& folder : index.files_by_folder) {
+		if (folder.second.first >= last) {
+			folder.second.first -= num_removed;
+		}
+		else if (folder.second.first > first) {
+			folder.second.first = first;
+		}
+	}
+	index.files.erase(index.files.begin() + first, index.files.begin() + last);
+	index.lower_files.erase(index.lower_files.begin() + first, index.lower_files.begin() + last);
+	index.num_conds.erase(index.num_conds.begin() + first, index.num_conds.begin() + last);
+	index.base_filenames.erase(index.base_filenames.begin() + first, index.base_filenames.begin() + last);
+	index.links.erase(index.links.begin() + first, index.links.begin() + last);
+	return true;
+}
+
+void CSVReader::set_media_index(const MediaIndex* png_index, const MediaIndex* mat_index) {
+	this->prebuilt_png_index = png_index;
+	this->prebuilt_mat_index = mat_index;
+}
+
+void CSVReader::compile_column_plan(const vector<wstring>& column_types, const vector<wstring>& variables, const vector<wstring>& units,
+	CSVColumnPlan& plan) {
+	plan.num_columns = column_types.size();
+	plan.params.clear();
+	plan.comments.clear();
+	plan.outs.clear();
+	for (size_t col = 0; col < column_types.size(); col++) {
+		// check if param name is not present skip column
+		if (col >= variables.size() || variables[col].empty()) {
+			continue;
+		}
+		const wstring& variable = variables[col];
+		// check if current column corresponds to parameter
+		if (column_types[col].compare(L"param") == 0) {
+			CSVColumnPlan::ParamColumn param;
+			param.col = col;
+			param.is_temp = false;
+			// construct meta_data key name (e.g. conv_VIO)
+			wstring key_name = L"cond_" + variable;
+			// handle special cases
+			if (this->convert_to_lower(key_name).compare(L"cond_temp") == 0) {
+				key_name = L"cond_tambient";
+				param.is_temp = true;
+			}
+			else if (key_name.compare(L"cond_vio") == 0) {
+				key_name = L"cond_VIO";
+			}
+			param.cond_key = this->string_pool->intern(key_name);
+			param.match_prefix = variable + L"=";
+			plan.params.push_back(move(param));
+		}
+		else if (column_types[col].compare(L"out") == 0) {
+			CSVColumnPlan::OutColumn out;
+			out.col = col;
+			// construct key_name from variables row, e.g. ibat_stb, and validate it
+			out.key_name = this->validate_param_name(variable);
+			out.test_name = this->string_pool->intern(out.key_name);
+			out.unit = col < units.size() ? units[col] : L"";
+			out.has_scale = false;
+			out.scale = 0;
+			plan.outs.push_back(move(out));
+		}
+		// check if current column corresponds to comment, PicturePath and WaveformPath are comment columns too
+		else if (this->convert_to_lower(column_types[col]).find(L"comment") != wstring::npos) {
+			CSVColumnPlan::CommentColumn comment;
+			comment.col = col;
+			comment.is_comment = variable != L"PicturePath";
+			comment.is_picture_path = variable == L"PicturePath";
+			comment.is_waveform_path = variable == L"WaveformPath";
+			plan.comments.push_back(comment);
+		}
+	}
+	plan.valid = true;
+}
+
+void CSVReader::get_corresponding_files(const vector<wstring>& lower_conditions, const MediaIndex& index, const vector<wstring>& pic_path,
+	vector<size_t>& candidates, vector<size_t>& matching_files) {
+	matching_files.clear();
+	// only files named in pic_path can match
+	candidates.clear();
+	for (const wstring& filename : pic_path) {
+		auto named = index.files_by_name.find(filename);
+		if (named != index.files_by_name.end()) {
+			candidates.insert(candidates.end(), named->second.begin(), named->second.end());
+		}
+	}
+	if (candidates.empty()) {
+		return;
+	}
+	// same filename can be given more than once, keep file order
+	sort(candidates.begin(), candidates.end());
+	candidates.erase(unique(candidates.begin(), candidates.end()), candidates.end());
+
+	for (size_t i : candidates) {
 		// deprecated for csv
 		// add one more condition for matching Report-Picture or Report-waveform names
-		//num_of_conds_in_filename++;
 		int num_of_conds_matched = 0;
-		for (auto file_match_cond : file_match_conditions) {
+		for (const wstring& lower_cond : lower_conditions) {
 			// count number of conditions that match with conditions in the filename
-			if (convert_to_lower(file).find(convert_to_lower(file_match_cond)) != wstring::npos) {
+			if (index.lower_files[i].find(lower_cond) != wstring::npos) {
 				num_of_conds_matched++;
 			}
 		}
 		// png file is matched if the number of total matched conditions are same as the number of 
 		// conditions in the filename
-		if (num_of_conds_matched == num_of_conds_in_filename) {
-			wstring base_filename = wstring(file).substr(wstring(file).find_last_of(L"/\\") + 1);
-			if (find(pic_path.begin(), pic_path.end(), base_filename) != pic_path.end()) {
-				matching_files.push_back(base_filename);
+		if (num_of_conds_matched == index.num_conds[i]) {
+			matching_files.push_back(i);
+		}
+	}
+}
+
+void CSVReader::trace_file_result(TraceSpan& span, const CSVFileResult& result, bool cached) {
+	// every test row is listed once in repeated_conds
+	size_t num_rows = 0;
+	for (const auto& repeated_cond : result.repeated_conds) {
+		num_rows += repeated_cond.second.size();
+	}
+	size_t num_files_matched = 0;
+	for (const auto& data_object : result.internal_json) {
+		num_files_matched += data_object.second.raw_data_link.size();
+	}
+	span.counter(L"rows", num_rows);
+	span.counter(L"data_objects", result.internal_json.size());
+	span.counter(L"files_matched", num_files_matched);
+	span.counter(L"cached", cached ? 1 : 0);
+}
+
+bool CSVReader::load_cached_result(const wstring& kind, const wstring& csv_file, uint64_t settings_hash, const MediaIndex& png_index,
+	const MediaIndex& mat_index, CSVFileResult& result) {
+	string payload;
+	if (this->conversion_cache == nullptr || !this->conversion_cache->load(kind, csv_file, settings_hash, payload)) {
+		return false;
+	}
+	CacheReader in(payload, this->string_pool);
+	// png or mat files the file can match were added or removed
+	uint64_t media_hash = 0;
+	in.get(result.png_names);
+	in.get(result.mat_names);
+	in.get(media_hash);
+	if (!in.good() || media_hash != this->hash_media(csv_file, result, png_index, mat_index)) {
+		result = CSVFileResult();
+		return false;
+	}
+	in.get(result.log);
+	for (int v = 0; v < NUM_CARRY_VALUES; v++) {
+		in.get(result.end_state.values[v]);
+	}
+	for (int r = 0; r < NUM_CARRY_ROWS; r++) {
+		in.get(result.end_state.rows[r]);
+	}
+	in.get(result.assigned_fields);
+	in.get(result.inherited_reads);
+	in.get(result.has_common_meta);
+	in.get(result.common_meta_position);
+	in.get(result.common_meta_basic_type);
+	in.get(result.common_meta_product_design_step);
+	in.get(result.common_meta_product_sales_code);
+	in.get(result.common_meta_username);
+	uint64_t num_out_cells = 0;
+	in.get(num_out_cells);
+	result.out_cells.resize(in.good() && num_out_cells <= payload.size() ? (size_t)num_out_cells : 0);
+	for (CSVOutCell& out_cell : result.out_cells) {
+		in.get(out_cell.key_name);
+		in.get(out_cell.unit);
+		in.get(out_cell.has_limit_rows);
+		in.get(out_cell.has_csv_limits);
+		in.get(out_cell.lsl);
+		in.get(out_cell.usl);
+	}
+	in.get(result.internal_json);
+	in.get(result.cond_repetition);
+	in.get(result.repeated_conds);
+	in.get(result.no_col_match_lines);
+	if (!in.good()) {
+		// broken entry, parse file again
+		result = CSVFileResult();
+		return false;
+	}
+	result.opened = true;
+	result.log = L"Using cached results for csv: " + csv_file + L"\n" + result.log;
+	return true;
+}
+
+void CSVReader::store_cached_result(const wstring& kind, const wstring& csv_file, uint64_t settings_hash, const MediaIndex& png_index,
+	const MediaIndex& mat_index, const CSVFileResult& result) {
+	if (this->conversion_cache == nullptr || !result.opened) {
+		return;
+	}
+	CacheWriter out;
+	out.put(result.png_names);
+	out.put(result.mat_names);
+	out.put(this->hash_media(csv_file, result, png_index, mat_index));
+	out.put(result.log);
+	for (int v = 0; v < NUM_CARRY_VALUES; v++) {
+		out.put(result.end_state.values[v]);
+	}
+	for (int r = 0; r < NUM_CARRY_ROWS; r++) {
+		out.put(result.end_state.rows[r]);
+	}
+	out.put(result.assigned_fields);
+	out.put(result.inherited_reads);
+	out.put(result.has_common_meta);
+	out.put((uint64_t)result.common_meta_position);
+	out.put(result.common_meta_basic_type);
+	out.put(result.common_meta_product_design_step);
+	out.put(result.common_meta_product_sales_code);
+	out.put(result.common_meta_username);
+	out.put((uint64_t)result.out_cells.size());
+	for (const CSVOutCell& out_cell : result.out_cells) {
+		out.put(out_cell.key_name);
+		out.put(out_cell.unit);
+		out.put(out_cell.has_limit_rows);
+		out.put(out_cell.has_csv_limits);
+		out.put(out_cell.lsl);
+		out.put(out_cell.usl);
+	}
+	out.put(result.internal_json);
+	out.put(result.cond_repetition);
+	out.put(result.repeated_conds);
+	out.put(result.no_col_match_lines);
+	this->conversion_cache->store(kind, csv_file, settings_hash, result.input_state, out.get_data());
+}
+
+uint64_t CSVReader::hash_media(const wstring& csv_file, const CSVFileResult& result, const MediaIndex& png_index, const MediaIndex& mat_index) {
+	uint64_t hash = 0;
+	// first mat file below the folder of the csv file gives cond_link_waveforms
+	auto mat_folder = mat_index.files_by_folder.find(csv_file.substr(0, csv_file.find_last_of(L"\\") + 1));
+	if (mat_folder != mat_index.files_by_folder.end()) {
+		hash = ConversionCache::hash_string(mat_index.files[mat_folder->second.first], hash);
+	}
+	// only files with a name from PicturePath or WaveformPath can be linked, wherever they are
+	const pair<const vector<wstring>*, const MediaIndex*> lookups[] = { { &result.png_names, &png_index }, { &result.mat_names, &mat_index } };
+	for (auto lookup : lookups) {
+		uint64_t separator = 0;
+		hash = ConversionCache::hash_bytes(&separator, sizeof(separator), hash);
+		for (const wstring& name : *lookup.first) {
+			hash = ConversionCache::hash_string(name, hash);
+			auto named = lookup.second->files_by_name.find(name);
+			if (named == lookup.second->files_by_name.end()) {
+				continue;
+			}
+			for (size_t i : named->second) {
+				hash = ConversionCache::hash_string(lookup.second->files[i], hash);
+			}
+		}
+	}
+	return hash;
+}
+
+uint64_t CSVReader::hash_carry_state(const CSVCarryState& state, uint64_t seed) {
+	uint64_t hash = seed;
+	for (int v = 0; v < NUM_CARRY_VALUES; v++) {
+		hash = ConversionCache::hash_string(state.values[v], hash);
+	}
+	for (int r = 0; r < NUM_CARRY_ROWS; r++) {
+		uint64_t num_cells = state.rows[r].size();
+		hash = ConversionCache::hash_bytes(&num_cells, sizeof(num_cells), hash);
+		for (const wstring& cell : state.rows[r]) {
+			hash = ConversionCache::hash_string(cell, hash);
+		}
+	}
+	return hash;
+}
+
+unsigned int CSVReader::carry_differences(const CSVCarryState& a, const CSVCarryState& b) {
+	unsigned int differences = 0;
+	for (int v = 0; v < NUM_CARRY_VALUES; v++) {
+		if (a.values[v] != b.values[v]) {
+			differences |= carry_value_bit(v);
+		}
+	}
+	for (int r = 0; r < NUM_CARRY_ROWS; r++) {
+		if (a.rows[r] != b.rows[r]) {
+			differences |= carry_row_bit(r);
+		}
+	}
+	return differences;
+}
+
+void CSVReader::parse_csv_file(const wstring& csv_file, const CSVCarryState& initial_state, map<wstring, wstring> configs_struct,
+							const MediaIndex& png_index, const MediaIndex& mat_index, CSVFileResult& result) {
+	// values carried over from previous file, tracked in result.assigned_fields once set by current file
+	CSVCarryState& state = result.end_state;
+	state = initial_state;
+	wstring& username = state.values[CARRY_USERNAME];
+	wstring& product_sales_code = state.values[CARRY_PRODUCT_SALES_CODE];
+	wstring& basic_type = state.values[CARRY_BASIC_TYPE];
+	wstring& product_design_step = state.values[CARRY_PRODUCT_DESIGN_STEP];
+	wstring& package = state.values[CARRY_PACKAGE];
+	wstring& dut_id = state.values[CARRY_DUT_ID];
+	wstring& api_id = state.values[CARRY_API_ID];
+	wstring& global_id = state.values[CARRY_GLOBAL_ID];
+	wstring& testunit_version = state.values[CARRY_TESTUNIT_VERSION];
+	vector <wstring>& column_types = state.rows[CARRY_COLUMN_TYPES];
+	vector <wstring>& variables = state.rows[CARRY_VARIABLES];
+	vector <wstring>& units = state.rows[CARRY_UNITS];
+	vector <wstring>& usl = state.rows[CARRY_USL];
+	vector <wstring>& lsl = state.rows[CARRY_LSL];
+	const unsigned int common_meta_fields = carry_value_bit(CARRY_USERNAME) | carry_value_bit(CARRY_PRODUCT_SALES_CODE) |
+		carry_value_bit(CARRY_BASIC_TYPE) | carry_value_bit(CARRY_PRODUCT_DESIGN_STEP);
+	wstring test_program_name = L"";
+	vector <wstring> test_data;
+
+	// represents temp structure, where each fieldname is wstring combining
+	// unique conditions(e.g. "{cond_vio}{cond_vbat}")
+	vector<pair<size_t, DataObject>>& internal_json = result.internal_json;
+	ConditionIndex internal_json_index;
+	ConditionIndex repeated_cond_index;
+
+	// keep count of lines in file
+	int line_count = 0;
+
+	// get parent folder name for png match
+	wstring curr_file = csv_file;
+	wstring parent_folder = curr_file.substr(0, curr_file.find_last_of(L"\\") + 1);
+	// wcout << "Parent folder: " << parent_folder << endl;
+	// conditions that will help to match corresponding png and .mat files for raw_data_link and waveform links
+	vector<wstring> file_match_conditions;
+	// add first png file match condition to png_file_match_conditions
+	file_match_conditions.push_back(parent_folder);
+
+	// start reading file
+	result.input_state = ConversionCache::file_state(csv_file);
+	LineReader inf;
+	if (!inf.open(csv_file, &result.input_state.content)) {
+		*this->log_stream << L"Couldn't read csv file: " << csv_file << endl;
+		return;
+	}
+	result.opened = true;
+
+	// get name of the folder containing csv file -> test_program_name
+	test_program_name = csv_file.substr(0, csv_file.find_last_of(L"\\"));
+	test_program_name = test_program_name.substr(test_program_name.find_last_of(L"\\") + 1, test_program_name.size() - 1);
+
+	// cond_link_* only depend on the file, they are built and interned once
+	// get cond_link as path to the folder containing current CSV file
+	PooledString cond_link_folder = this->string_pool->intern(L"file:///" + this->strrep(csv_file.substr(0, csv_file.find_last_of(L"\\")), '\\', '/'));
+	PooledString cond_link_waveforms = StringPool::empty();
+	// get cond_link_waveforms
+	// mat files below parent folder are looked up in the index
+	auto mat_folder = mat_index.files_by_folder.find(parent_folder);
+	int matching_mat_files_count = mat_folder != mat_index.files_by_folder.end() ? mat_folder->second.second : 0;
+	wstring matching_mat_filename{};
+	/*
+	// FOR CONSTRUCTING BASED ON THE SPECIFIC FILENAME FOR MAT EXPLORER TOOL
+	vector<wstring> matching_mat_files{};
+	if (matching_mat_files_count > 1) {
+		matching_mat_files = get_corresponding_files(file_match_conditions, mat_files);
+		// there is only one mat file per condition combination
+		if (matching_mat_files.size() > 0) {
+			matching_mat_filename = matching_mat_files[0];
+		}
+	}
+	else if (matching_mat_files_count == 1) {
+		// only one mat file, matching is done based on parent folder name
+		for (auto mat_file : mat_files) {
+			if (mat_file.find(parent_folder) != wstring::npos) {
+				matching_mat_filename = mat_file;
 			}
 		}
 	}
-	return matching_files;
-}
\ No newline at end of file
+	*/
+	// since for now we use only folder name, it doesn't matter how many files matched. All of them are in the same folder
+	if (matching_mat_files_count > 0) {
+		matching_mat_filename = mat_index.files[mat_folder->second.first];
+	}
+	// constuct proper cond_link_waveforms if matching mat file was found
+	if (!matching_mat_filename.empty()) {
+		// TODO: uncomment this for cond_link_waveforms
+		// meta_data[L"cond_link_waveforms"] = L"file:///" + waveform_explorer_path + L" /k " + matching_mat_filename;
+		// meta_data[L"cond_link_waveforms"] = strrep(meta_data[L"cond_link_waveforms"], '\\', '/');
+		cond_link_waveforms = this->string_pool->intern(L"file:///" + this->strrep(matching_mat_filename.substr(0, matching_mat_filename.find_last_of(L"\\")), '\\', '/'));
+	}
+	// wcout << *cond_link_waveforms << endl;
+
+	// interned keys used for every data object
+	PooledString cond_link_screenshots_key = this->string_pool->intern(L"cond_link_screenshots");
+	PooledString cond_link_raw_data_key = this->string_pool->intern(L"cond_link_raw_data");
+	PooledString cond_link_waveforms_key = this->string_pool->intern(L"cond_link_waveforms");
+	PooledString package_key = this->string_pool->intern(L"package");
+	PooledString user_name_key = this->string_pool->intern(L"user_name");
+	PooledString rddf_tc_id_key = this->string_pool->intern(L"rddf_tc_id");
+	PooledString test_program_name_key = this->string_pool->intern(L"test_program_name");
+	PooledString test_program_revision_key = this->string_pool->intern(L"test_program_revision");
+	// meta values of the rows only change with a #meta line, they are interned once for all rows after it (intern_meta_values)
+	PooledString test_program_name_value = this->string_pool->intern(test_program_name);
+	PooledString dut_id_value = StringPool::empty();
+	PooledString package_value = StringPool::empty();
+	PooledString user_name_value = StringPool::empty();
+	PooledString rddf_tc_id_value = StringPool::empty();
+	PooledString test_program_revision_value = StringPool::empty();
+	auto intern_meta_values = [&]() {
+		dut_id_value = this->string_pool->intern(dut_id);
+		package_value = this->string_pool->intern(package);
+		user_name_value = this->string_pool->intern(username);
+		// rddf_tc_id only if api_id and global_id are set
+		rddf_tc_id_value = !api_id.empty() && !global_id.empty() ? this->string_pool->intern(api_id + L":" + global_id) : StringPool::empty();
+		test_program_revision_value = this->string_pool->intern(testunit_version);
+	};
+	PooledString mat_type = this->string_pool->intern(L"MAT");
+	PooledString png_type = this->string_pool->intern(L"PNG");
+
+	*this->log_stream << L"Reading csv: " << csv_file << endl << endl;
+	// for manual measurement meta data is coming from configs_struct
+	if (!configs_struct[L"user"].empty()) {
+		username = configs_struct[L"user"];
+		result.assigned_fields |= carry_value_bit(CARRY_USERNAME);
+	}
+	if (!configs_struct[L"product_sales_code"].empty()) {
+		product_sales_code = configs_struct[L"product_sales_code"];
+		result.assigned_fields |= carry_value_bit(CARRY_PRODUCT_SALES_CODE);
+	}
+	if (!configs_struct[L"basic_type"].empty()) {
+		basic_type = configs_struct[L"basic_type"];
+		result.assigned_fields |= carry_value_bit(CARRY_BASIC_TYPE);
+	}
+	if (!configs_struct[L"product_design_step"].empty()) {
+		product_design_step = configs_struct[L"product_design_step"];
+		result.assigned_fields |= carry_value_bit(CARRY_PRODUCT_DESIGN_STEP);
+	}
+	if (!configs_struct[L"package"].empty()) {
+		package = configs_struct[L"package"];
+		result.assigned_fields |= carry_value_bit(CARRY_PACKAGE);
+	}
+	if (!configs_struct[L"dut_id"].empty()) {
+		dut_id = configs_struct[L"dut_id"];
+		result.assigned_fields |= carry_value_bit(CARRY_DUT_ID);
+	}
+	if (!configs_struct[L"api_id"].empty()) {
+		api_id = configs_struct[L"api_id"];
+		result.assigned_fields |= carry_value_bit(CARRY_API_ID);
+	}
+	if (!configs_struct[L"global_id"].empty()) {
+		global_id = configs_struct[L"global_id"];
+		result.assigned_fields |= carry_value_bit(CARRY_GLOBAL_ID);
+	}
+	if (!configs_struct[L"testunit_version"].empty()) {
+		testunit_version = configs_struct[L"testunit_version"];
+		result.assigned_fields |= carry_value_bit(CARRY_TESTUNIT_VERSION);
+	}
+
+	// remember first point where common meta data could be created, the merge creates it if no previous file did
+	result.inherited_reads |= common_meta_fields & ~result.assigned_fields;
+	if (basic_type != L"" && product_sales_code != L"" && product_design_step != L"") {
+		result.has_common_meta = true;
+		result.common_meta_position = 0;
+		result.common_meta_basic_type = basic_type;
+		result.common_meta_product_design_step = product_design_step;
+		result.common_meta_product_sales_code = product_sales_code;
+		result.common_meta_username = username;
+	}
+	intern_meta_values();
+	
+	string_view raw_line;
+	wstring strInp;
+	// tokens of current line, views into strInp
+	vector<wstring_view> line_data;
+	// temporaries of test rows, reused from row to row
+	CSVRowScratch row;
+	// header rows compiled for test rows, carried over header rows are compiled with the first test row
+	CSVColumnPlan plan;
+	while (inf.next_line(raw_line)) {
+		LineReader::decode(raw_line, strInp);
+		line_count++;
+		if (strInp.find(L"#meta") != wstring::npos) {
+			// read meta for following data lines
+			// some csvs have format basic_type : S1234, some have format
+			// basic_type, S1234. ; is used by Bucharest data
+			// separate #meta lines on all three
+			Tokenizer::split(strInp, L",:;", true, line_data);
+
+			// iterate through each meta word chunk(key, value)
+			// if the keyword is found in chunk, then value is in next chunk, so
+			// setting index to next counter
+			for (int counter = 0; counter < line_data.size(); counter++) {
+				if (line_data[counter].find(L"user") != wstring::npos && line_data[counter].find(L"email") == wstring::npos) {
+					// if username is not set in configs read from CSV
+					if (configs_struct[L"Username"].empty()) {
+						username = line_data[counter + 1];
+						username = this->strtrim(username);
+					}
+					else {
+						username = configs_struct[L"Username"];
+					}
+					result.assigned_fields |= carry_value_bit(CARRY_USERNAME);
+				}
+				else if (line_data[counter].find(L"product_sales_code") != wstring::npos) {
+					product_sales_code = line_data[counter + 1];
+					product_sales_code = this->strtrim(product_sales_code);
+					result.assigned_fields |= carry_value_bit(CARRY_PRODUCT_SALES_CODE);
+				}
+				else if (line_data[counter].find(L"basic_type") != wstring::npos) {
+					basic_type = line_data[counter + 1];
+					basic_type = this->strtrim(basic_type);
+					result.assigned_fields |= carry_value_bit(CARRY_BASIC_TYPE);
+				}
+				else if (line_data[counter].find(L"product_design_step") != wstring::npos) {
+					product_design_step = line_data[counter + 1];
+					product_design_step = this->strtrim(product_design_step);
+					result.assigned_fields |= carry_value_bit(CARRY_PRODUCT_DESIGN_STEP);
+				}
+				else if (line_data[counter].find(L"package") != wstring::npos) {
+					package = line_data[counter + 1];
+					package = this->strtrim(package);
+					result.assigned_fields |= carry_value_bit(CARRY_PACKAGE);
+				}
+				else if (line_data[counter].find(L"dut_id") != wstring::npos) {					
+					dut_id = line_data[counter + 1];
+					dut_id = this->strtrim(dut_id);
+					result.assigned_fields |= carry_value_bit(CARRY_DUT_ID);
+					// clear previous dut_id condition if there was any
+					while (file_match_conditions.size() > 1) {
+						file_match_conditions.pop_back();
+					}
+					// add as sample={dut_id} to png conditions match list
+					file_match_conditions.push_back(L"sample=" + dut_id);
+				}
+				else if (line_data[counter].find(L"api_id") != wstring::npos) {
+					api_id = line_data[counter + 1];
+					api_id = this->strtrim(api_id);
+					result.assigned_fields |= carry_value_bit(CARRY_API_ID);
+				}
+				else if (line_data[counter].find(L"global_id") != wstring::npos) {
+					global_id = line_data[counter + 1];
+					global_id = this->strtrim(global_id);
+					result.assigned_fields |= carry_value_bit(CARRY_GLOBAL_ID);
+				}
+				else if (line_data[counter].find(L"testunit_version") != wstring::npos) {
+					testunit_version = line_data[counter + 1];
+					testunit_version = this->strtrim(testunit_version);
+					result.assigned_fields |= carry_value_bit(CARRY_TESTUNIT_VERSION);
+				}
+			}
+			if (!result.has_common_meta) {
+				result.inherited_reads |= common_meta_fields & ~result.assigned_fields;
+				if (basic_type != L"" && product_sales_code != L"" && product_design_step != L"") {
+					result.has_common_meta = true;
+					result.common_meta_position = result.out_cells.size();
+					result.common_meta_basic_type = basic_type;
+					result.common_meta_product_design_step = product_design_step;
+					result.common_meta_product_sales_code = product_sales_code;
+					result.common_meta_username = username;
+				}
+			}
+			intern_meta_values();
+		}
+		else {
+			// reading other than #meta lines
+			// separate test data line on ; and , (Buch data)
+			Tokenizer::split(strInp, L";,", false, line_data);
+			// to check for empty csv files, if columns are less than 3 skip them
+			// less than 3, because sometimes it can contains dummy values
+			if (line_data.size() < 3) {
+				continue;
+			}
+			// check type of line (col types, var names, units or test data)
+			if (strInp.find(L"Columns type") != wstring::npos) {
+				Tokenizer::assign(line_data, column_types);
+				plan.valid = false;
+				result.assigned_fields |= carry_row_bit(CARRY_COLUMN_TYPES);
+				// iterate through column types, if any is empty report to user
+				for (int i = 0; i < column_types.size(); i++) {
+					if (column_types[i].empty()) {
+						wstring col_name = this->get_excel_col_name(i+1);
+						*this->log_stream << L"WARNING: Empty entry for Column Types at " << to_wstring(line_count) + col_name << L". Column "
+							<< col_name << L" will be skipped!" << endl;
+					}
+				}
+			}
+			else if (strInp.find(L"Variables") != wstring::npos) {
+				Tokenizer::assign(line_data, variables);
+				plan.valid = false;
+				result.assigned_fields |= carry_row_bit(CARRY_VARIABLES);
+				// iterate through param names, if any is empty report to user 
+				for (int i = 0; i < variables.size(); i++) {
+					if (variables[i].empty()) {
+						wstring col_name = this->get_excel_col_name(i+1);
+						*this->log_stream << L"WARNING: Empty entry for Variables at " << to_wstring(line_count) + col_name << L". Column "
+							<< col_name << L" will be skipped!" << endl;
+					}
+				}
+			}
+			else if (strInp.find(L"Units") != wstring::npos) {
+				Tokenizer::assign(line_data, units);
+				plan.valid = false;
+				result.assigned_fields |= carry_row_bit(CARRY_UNITS);
+			}
+			else if (strInp.find(L"LSL") != wstring::npos) {
+				Tokenizer::assign(line_data, lsl);
+				result.assigned_fields |= carry_row_bit(CARRY_LSL);
+			}
+			else if (strInp.find(L"USL") != wstring::npos) {
+				Tokenizer::assign(line_data, usl);
+				result.assigned_fields |= carry_row_bit(CARRY_USL);
+			}
+			else if (strInp[0] == '#' || all_of(line_data.begin(), line_data.end(), [](wstring_view elem) { return elem.empty(); })) {
+				// skip all other rows starting with # or having empty vals
+			}
+			else {
+				// if none of the above, then it's a test data
+				// test rows use all carried over values
+				result.inherited_reads |= ~result.assigned_fields & (carry_row_bit(NUM_CARRY_ROWS) - 1);
+				// strings of previous row are reused
+				Tokenizer::assign(line_data, test_data);
+				// meta_data holding the conditions of current row (shared by its test values), comments, pic_path and wfm_path are in row
+				row.clear();
+				RowMetaData& meta_data = row.meta_data;
+				// meta_data as it is given to data objects, copied once with the first out value of the row
+				shared_ptr<const RowMetaData> row_meta_data;
+				// hash of combination of conditions
+				ConditionHash cond_str;
+				int num_conds = 0;
+				// header rows changed since the last test row
+				if (!plan.valid) {
+					this->compile_column_plan(column_types, variables, units, plan);
+				}
+				// save line number for each value which doesn't correspond to any column header to report the error
+				for (size_t current_col = plan.num_columns; current_col < test_data.size(); current_col++) {
+					result.no_col_match_lines.push_back(line_count);
+				}
+				// go through param columns to build meta_data
+				for (const CSVColumnPlan::ParamColumn& param : plan.params) {
+					if (param.col >= test_data.size()) {
+						break;
+					}
+					wstring& value = test_data[param.col];
+					// if temperature is empty, make it 0
+					if (param.is_temp && value.empty()) {
+						*this->log_stream << L"TEMP IS EMPTY AT " << line_count << endl;
+						value = L"0";
+					}
+					// combine conditions
+					cond_str.add(value);
+					num_conds++;
+					meta_data.set_cond(param.cond_key, this->string_pool->intern(value));
+					// add each condition to the png_file_match_conditions with values. add [ as end of condition (e.g. vio=3[V])
+					file_match_conditions.push_back(param.match_prefix + value + L"[");
+				}
+				// go through comment columns to collect comments, picture path and waveform path
+				for (const CSVColumnPlan::CommentColumn& comment : plan.comments) {
+					if (comment.col >= test_data.size()) {
+						break;
+					}
+					const wstring& value = test_data[comment.col];
+					if (value.empty()) {
+						continue;
+					}
+					if (comment.is_comment) {
+						row.comments.push_back(this->string_pool->intern(value));
+					}
+					if (comment.is_picture_path) {
+						row.pic_path.push_back(value);
+					}
+					if (comment.is_waveform_path) {
+						row.wfm_path.push_back(value);
+					}
+				}
+				// add cond_link_* and meta fields which are the same for the whole row
+				meta_data.set_cond(cond_link_screenshots_key, cond_link_folder);
+				meta_data.set_cond(cond_link_raw_data_key, cond_link_folder);
+				if (cond_link_waveforms != StringPool::empty()) {
+					meta_data.set_cond(cond_link_waveforms_key, cond_link_waveforms);
+				}
+				meta_data.dut_id = dut_id_value;
+				meta_data.set_meta(package_key, package_value);
+				meta_data.set_meta(user_name_key, user_name_value);
+				if (rddf_tc_id_value != StringPool::empty()) {
+					meta_data.set_meta(rddf_tc_id_key, rddf_tc_id_value);
+				}
+				meta_data.set_meta(test_program_name_key, test_program_name_value);
+				meta_data.set_meta(test_program_revision_key, test_program_revision_value);
+
+				// meta values of the row are part of the combination (only if there is any condition)
+				if (num_conds > 0) {
+					cond_str.add(username);
+					cond_str.add(basic_type);
+					cond_str.add(product_sales_code);
+					cond_str.add(product_design_step);
+					cond_str.add(package);
+					cond_str.add(dut_id);
+				}
+				size_t repeated_cond = repeated_cond_index.insert(cond_str, result.repeated_conds.size());
+				if (repeated_cond == result.repeated_conds.size()) {
+					result.repeated_conds.push_back(make_pair(cond_str, vector<int>()));
+				}
+				result.repeated_conds[repeated_cond].second.push_back(line_count);
+				// conditions are the same for all out values of the row, so are the matching png and mat files
+				if (!plan.outs.empty()) {
+					row.lower_conditions.resize(file_match_conditions.size() + 1);
+					for (size_t i = 0; i < file_match_conditions.size(); i++) {
+						row.lower_conditions[i].assign(file_match_conditions[i]);
+						this->convert_to_lower_in_place(row.lower_conditions[i]);
+					}
+					// upadte 22.12.2021 matching is also based on pic_path
+					row.lower_conditions.back().assign(L"report-picture");
+					get_corresponding_files(row.lower_conditions, png_index, row.pic_path, row.candidates, row.matching_png_files);
+					row.lower_conditions.back().assign(L"report-waveform");
+					get_corresponding_files(row.lower_conditions, mat_index, row.wfm_path, row.candidates, row.matching_mat_files);
+					// names of all looked up files are cached with the result, see hash_media
+					for (const wstring& name : row.pic_path) {
+						auto png_name = lower_bound(result.png_names.begin(), result.png_names.end(), name);
+						if (png_name == result.png_names.end() || *png_name != name) {
+							result.png_names.insert(png_name, name);
+						}
+					}
+					for (const wstring& name : row.wfm_path) {
+						auto mat_name = lower_bound(result.mat_names.begin(), result.mat_names.end(), name);
+						if (mat_name == result.mat_names.end() || *mat_name != name) {
+							result.mat_names.insert(mat_name, name);
+						}
+					}
+				}
+				// go through out columns and for each out value
+				// construct dataObject with payload + meta_data
+				for (CSVColumnPlan::OutColumn& out : plan.outs) {
+					if (out.col >= test_data.size()) {
+						break;
+					}
+					size_t current_col = out.col;
+					// skip if empty
+					if (test_data[current_col].empty()) {
+						continue;
+					}
+					// create dataObject for current out value with conditions of current row, it is kept in internal_json
+					if (!row_meta_data) {
+						row_meta_data = make_shared<const RowMetaData>(meta_data);
+					}
+					DataObject data_object;
+					data_object.row = row_meta_data;
+					// add out param name to keep param conds str separately
+					ConditionHash key_cond_str = cond_str.with(out.key_name);
+					
+					// scale according to unit
+					if (!out.has_scale) {
+						out.scale = get<0>(this->get_unit_scale(out.unit));
+						out.has_scale = true;
+					}
+					NumericScaler::scale(out.scale, test_data[current_col], data_object.value);
+					data_object.test_name = out.test_name;
+					
+					// save related .mat and png files to current payload
+					for (size_t i : row.matching_mat_files) {
+						data_object.raw_data_link.push_back(make_pair(mat_type, mat_index.links[i]));
+					}
+					for (size_t i : row.matching_png_files) {
+						data_object.raw_data_link.push_back(make_pair(png_type, png_index.links[i]));
+					}
+					// save related comments
+					data_object.comments = row.comments;
+
+					// test number and limit object depend on all previous files, they are added
+					// when merging. save everything needed for it
+					CSVOutCell out_cell;
+					out_cell.key_name = out.key_name;
+					out_cell.unit = out.unit;
+					out_cell.has_limit_rows = !usl.empty() || !lsl.empty();
+					out_cell.has_csv_limits = !lsl.empty() && !usl.empty() && current_col < lsl.size() && current_col < usl.size()
+						&& !lsl[current_col].empty() && !usl[current_col].empty();
+					if (out_cell.has_csv_limits) {
+						out_cell.lsl = lsl[current_col];
+						out_cell.usl = usl[current_col];
+					}
+					result.out_cells.push_back(move(out_cell));
+
+					// store current metaData and payload in internal_json
+					size_t object_index = internal_json_index.insert(key_cond_str, internal_json.size());
+					if (object_index == internal_json.size()) {
+						internal_json.push_back(make_pair(result.out_cells.size() - 1, move(data_object)));
+					}
+					else {
+						// key_cond_str is already in internal_json, condition repetition occurred
+						// mark flag true to inform user
+						result.cond_repetition = true;
+						internal_json[object_index] = make_pair(result.out_cells.size() - 1, move(data_object));
+					}
+				}
+				// clear png file match conditions (skip first two for parent folder and dut it)
+				while (file_match_conditions.size() > 2) {
+					file_match_conditions.pop_back();
+				}
+			}
+		}
+	} // finished reading current csv -> while(inf.next_line)
+}
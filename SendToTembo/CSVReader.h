@@ -5,13 +5,23 @@
 #include <iostream>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <time.h>
 #include <codecvt>
 #include <algorithm>
 #include <tuple>
 #include <sstream>
 #include "DataReader.h"
+#include "LineReader.h"
+#include "ConditionHash.h"
+#include "LimitsIndex.h"
+#include "TestNumberRegistry.h"
+#include "ThreadPool.h"
+#include "InputCatalog.h"
 #include <chrono>
+#include <mutex>
+#include <memory>
+#include <condition_variable>
 
 /*************************************************************************************************************************************************************************
 * maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
@@ -32,20 +42,335 @@ private:
 	wstring file_path;
 	wstring waveform_explorer_path = L"\\\\mucsdn31\\ATV_Power_Dev\\PSN_ProductEngineering\\CV\\Projects\\CV_framework_PSN\\Group3_CV_Reporting\\Tembo\\PSN_Development\\WaveformExplorer\\WaveformExplorer\\for_redistribution_files_only\\WaveformExplorer.exe";
 
+	// values which are carried over from one csv file to the next one, if the next file doesn't set them itself
+	enum CarryValue { CARRY_USERNAME, CARRY_PRODUCT_SALES_CODE, CARRY_BASIC_TYPE, CARRY_PRODUCT_DESIGN_STEP, CARRY_PACKAGE, CARRY_DUT_ID,
+		CARRY_API_ID, CARRY_GLOBAL_ID, CARRY_TESTUNIT_VERSION, NUM_CARRY_VALUES };
+	// header rows which are carried over the same way
+	enum CarryRow { CARRY_COLUMN_TYPES, CARRY_VARIABLES, CARRY_UNITS, CARRY_USL, CARRY_LSL, NUM_CARRY_ROWS };
+	static unsigned int carry_value_bit(int value) { return 1u << value; }
+	static unsigned int carry_row_bit(int row) { return 1u << (NUM_CARRY_VALUES + row); }
+
+	struct CSVCarryState {
+		wstring values[NUM_CARRY_VALUES];
+		vector<wstring> rows[NUM_CARRY_ROWS];
+	};
+
+	// out value of a test row, everything needed to assign its test number and limit object when merging
+	struct CSVOutCell {
+		wstring key_name;
+		wstring unit;
+		// LSL/USL rows are present in csv
+		bool has_limit_rows = false;
+		// LSL and USL are given in csv for this column
+		bool has_csv_limits = false;
+		wstring lsl;
+		wstring usl;
+	};
+
+	// everything parse_csv_file produces for one csv file
+	struct CSVFileResult {
+		bool opened = false;
+		// console output of parsing
+		wstring log;
+		// error which stopped parsing (e.g. invalid unit), log holds the message
+		exception_ptr error;
+		// csv file as it was parsed, stored with the result in the conversion cache
+		CacheFileState input_state;
+		// sorted names from PicturePath and WaveformPath of all rows, png and mat files with these names could be linked
+		vector<wstring> png_names;
+		vector<wstring> mat_names;
+		// carried over values at the end of the file
+		CSVCarryState end_state;
+		// carried over values set by the file (bits of carry_value_bit/carry_row_bit)
+		unsigned int assigned_fields = 0;
+		// carried over values used before the file set them
+		unsigned int inherited_reads = 0;
+		// first point where common_meta_data could be created (number of out_cells before it) and its values
+		bool has_common_meta = false;
+		size_t common_meta_position = 0;
+		wstring common_meta_basic_type;
+		wstring common_meta_product_design_step;
+		wstring common_meta_product_sales_code;
+		wstring common_meta_username;
+		// all out values of the file in order
+		vector<CSVOutCell> out_cells;
+		// last data object per key_cond_str with index of its out cell in order of first occurrence, test_number is still missing
+		vector<pair<size_t, DataObject>> internal_json;
+		bool cond_repetition = false;
+		// lines per cond_str in order of first occurrence
+		vector<pair<ConditionHash, vector<int>>> repeated_conds;
+		vector<int> no_col_match_lines;
+	};
+
+public:
+	// png or mat files prepared for get_corresponding_files, once per conversion or kept up to date by the caller (set_media_index).
+	// All vectors are indexed like files, which are sorted like the lists of InputCatalog (InputCatalog::path_less)
+	struct MediaIndex {
+		vector<wstring> files;
+		// convert_to_lower of each file
+		vector<wstring> lower_files;
+		// number of conditions in the file path ('=' count + 1 for the parent folder)
+		vector<int> num_conds;
+		vector<wstring> base_filenames;
+		// base filename with '/' as saved in raw_data_link
+		vector<PooledString> links;
+		// base filename -> indices of all files with that name, in file order
+		unordered_map<wstring, vector<size_t>> files_by_name;
+		// every folder of a file path (with trailing '\\') -> index of first file below it and number of files below it
+		unordered_map<wstring, pair<size_t, int>> files_by_folder;
+	};
+
+private:
+	// what test rows do with each column, compiled from the Columns type, Variables and Units rows by compile_column_plan.
+	// All lists are in column order
+	struct CSVColumnPlan {
+		// param column, cond_* key with cond_tambient / cond_VIO already replaced, "<variable>=" of its file match condition
+		struct ParamColumn {
+			size_t col;
+			PooledString cond_key;
+			// empty temperature values are saved as 0
+			bool is_temp;
+			wstring match_prefix;
+		};
+		// comment column, PicturePath columns only give picture paths, WaveformPath columns are comments and waveform paths
+		struct CommentColumn {
+			size_t col;
+			bool is_comment;
+			bool is_picture_path;
+			bool is_waveform_path;
+		};
+		// out column, validated parameter name and unit as given in the Units row
+		struct OutColumn {
+			size_t col;
+			wstring key_name;
+			PooledString test_name;
+			wstring unit;
+			// scale of unit, get_unit_scale throws on invalid units, so it is only looked up for the first value
+			bool has_scale;
+			int scale;
+		};
+
+		// rows are compiled again after one of the header rows changed
+		bool valid = false;
+		// number of entries in Columns type, values behind it don't match any column
+		size_t num_columns = 0;
+		vector<ParamColumn> params;
+		vector<CommentColumn> comments;
+		vector<OutColumn> outs;
+	};
+
+	// temporaries of a test row in parse_csv_file. They live as long as the file is parsed and are cleared per row,
+	// so after the first rows their buffers are big enough and a row doesn't allocate anymore. Only the data objects, one
+	// copy of meta_data shared by them and the out cells are kept
+	struct CSVRowScratch {
+		RowMetaData meta_data;
+		vector<PooledString> comments;
+		vector<wstring> pic_path;
+		vector<wstring> wfm_path;
+		// convert_to_lower of the file match conditions of the row, the last one is report-picture or report-waveform
+		vector<wstring> lower_conditions;
+		// indices into MediaIndex of candidates and matching files of get_corresponding_files
+		vector<size_t> candidates;
+		vector<size_t> matching_png_files;
+		vector<size_t> matching_mat_files;
+
+		void clear() {
+			meta_data.clear();
+			comments.clear();
+			pic_path.clear();
+			wfm_path.clear();
+		}
+	};
+
+
+	/*************************************************************************************************************************************************************************
+	* This function compares two carry states
+	*
+	* Input:
+	*		a, b				CSVCarryState		states to compare
+	* Output:
+	*		differences			unsigned int		bits (carry_value_bit/carry_row_bit) of all values that differ
+	*
+	*************************************************************************************************************************************************************************/
+	unsigned int carry_differences(const CSVCarryState&, const CSVCarryState&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function parses a single csv file into data objects
+	*
+	* Input:
+	*		csv_file			wstring						path to csv file
+	*		initial_state		CSVCarryState				meta data and header rows left by previous file
+	*		configs_struct		map<wstring, wstring>		structure containing configurations
+	*		png_index			MediaIndex					all png files for raw_data_link matching
+	*		mat_index			MediaIndex					all mat files for raw_data_link and cond_link_waveforms matching
+	* Output:
+	*		result				CSVFileResult				data objects, out values and reports of the file
+	*
+	* This is the per file part of csvs_to_json, see there for details. It doesn't touch anything shared with other files, so
+	* files can be parsed in parallel. Everything depending on previous files (test numbers, limit objects, common_meta_data)
+	* is left to the merge in csvs_to_json.
+	* result.inherited_reads tells which values of initial_state were used. If they differ from what previous files really left,
+	* the file has to be parsed again with the correct initial_state.
+	*
+	*************************************************************************************************************************************************************************/
+	void parse_csv_file(const wstring&, const CSVCarryState&, map<wstring, wstring>, const MediaIndex&, const MediaIndex&, CSVFileResult&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function compiles the header rows of a csv file into a column plan
+	*
+	* Input:
+	*		column_types		vector<wstring>				Columns type row (param, out, comment, ...)
+	*		variables			vector<wstring>				Variables row, columns without name are skipped
+	*		units				vector<wstring>				Units row
+	* Output:
+	*		plan				CSVColumnPlan				param, comment and out columns with everything derived from the header
+	*
+	* Names, cond_* keys and parameter names are built and interned here once per header, test rows only go through the lists of
+	* the plan instead of checking every column.
+	*
+	*************************************************************************************************************************************************************************/
+	void compile_column_plan(const vector<wstring>&, const vector<wstring>&, const vector<wstring>&, CSVColumnPlan&);
+
+
+	/*************************************************************************************************************************************************************************
+	* These functions load and store the result of parse_csv_file in the conversion cache
+	*
+	* Input:
+	*		kind				wstring						csv for results parsed with an empty CSVCarryState, csv_carried for results parsed again in the merge
+	*		csv_file			wstring						path to csv file
+	*		settings_hash		uint64_t					hash of configurations used for parsing (and of carried over values, see hash_carry_state)
+	*		png_index			MediaIndex					all png files of the conversion
+	*		mat_index			MediaIndex					all mat files of the conversion
+	*		result				CSVFileResult				(store) result of parsing csv_file
+	* Output:
+	*		result				CSVFileResult				(load) cached result, log starts with a note that the file wasn't parsed again
+	*		res					bool						(load) whether csv_file was found unchanged in cache
+	*
+	* Nothing is loaded or stored if no cache was set (set_conversion_cache).
+	* The result is stored with hash_media of its png and mat names, it isn't loaded if one of the files it could match was added or removed.
+	*
+	*************************************************************************************************************************************************************************/
+	bool load_cached_result(const wstring&, const wstring&, uint64_t, const MediaIndex&, const MediaIndex&, CSVFileResult&);
+	void store_cached_result(const wstring&, const wstring&, uint64_t, const MediaIndex&, const MediaIndex&, const CSVFileResult&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function hashes the png and mat files a parsed csv file depends on
+	*
+	* Input:
+	*		csv_file			wstring						path to csv file
+	*		result				CSVFileResult				png_names and mat_names of the parsed file
+	*		png_index			MediaIndex					all png files
+	*		mat_index			MediaIndex					all mat files
+	* Output:
+	*		hash				uint64_t					hash of the first mat file below the folder of csv_file (cond_link_waveforms) and of all
+	*														files named in png_names and mat_names
+	*
+	* A new picture somewhere else doesn't change the hash, so only the csv files which can link it are parsed again.
+	*
+	*************************************************************************************************************************************************************************/
+	uint64_t hash_media(const wstring&, const CSVFileResult&, const MediaIndex&, const MediaIndex&);
+
+	// adds rows, data objects and matched png/mat files of a parsed or cached file to its trace span
+	void trace_file_result(TraceSpan&, const CSVFileResult&, bool cached);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function hashes all values of a carry state
+	*
+	* Input:
+	*		state				CSVCarryState				carried over values
+	*		seed				uint64_t					hash to continue
+	* Output:
+	*		hash				uint64_t					hash of seed and all values and rows of state
+	*
+	*************************************************************************************************************************************************************************/
+	uint64_t hash_carry_state(const CSVCarryState&, uint64_t);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function prepares the limits of one line of the limits file
+	*
+	* Input:
+	*		name				wstring						parameter name
+	*		limit_struct		map<wstring, wstring>		<limit_key, limit_value> of the line, e.g. <LSL, 1>
+	* Output:
+	*		limit				LimitRecord					TestNr, unit, scale, scaled LSL/USL, Typ, ReqID and Description of the line
+	*
+	*************************************************************************************************************************************************************************/
+	void compile_limit(const wstring&, map<wstring, wstring>&, LimitRecord&);
+
+	// computes lower case path, condition count, base filename and link of index.files[i]
+	void prepare_media_file(MediaIndex& index, size_t i);
+
+	// indices of set_media_index, nullptr if csvs_to_json builds them
+	const MediaIndex* prebuilt_png_index = nullptr;
+	const MediaIndex* prebuilt_mat_index = nullptr;
+
 public:
 	CSVReader();
 	~CSVReader();
 
 
+	/*************************************************************************************************************************************************************************
+	* This function prepares png or mat files for matching
+	*
+	* Input:
+	*		files				vector<wstring>				all png or mat files
+	* Output:
+	*		index				MediaIndex					lower case paths, condition counts, base filenames and lookup tables of files
+	*
+	* Everything get_corresponding_files needs from a file path is computed here once, instead of once per out value.
+	*
+	*************************************************************************************************************************************************************************/
+	void build_media_index(const vector<wstring>&, MediaIndex&);
+
+
+	/*************************************************************************************************************************************************************************
+	* These functions update a MediaIndex when a single png or mat file was added or a file or folder was removed
+	*
+	* Input:
+	*		file_path			wstring						absolute path of the file (remove_media_path: of a file or folder)
+	*		index				MediaIndex					index built by build_media_index
+	* Output:
+	*		index				MediaIndex					same index as build_media_index of the changed file list
+	*		res					bool						add_media_file: whether file wasn't in the index yet
+	*														remove_media_path: whether anything was removed
+	*
+	* Only the changed file is prepared, the other files just move by one position. Used by long running conversions (WatchDaemon),
+	* which keep the index between conversions instead of building it for every change.
+	*
+	*************************************************************************************************************************************************************************/
+	bool add_media_file(const wstring&, MediaIndex&);
+	bool remove_media_path(const wstring&, MediaIndex&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function sets prebuilt indices of the png and mat files given to csvs_to_json
+	*
+	* Input:
+	*		png_index			MediaIndex*					index of png_files, nullptr (default) builds it in every csvs_to_json
+	*		mat_index			MediaIndex*					index of mat_files, nullptr (default) builds it in every csvs_to_json
+	*
+	* Indices have to be built from the same files as passed to csvs_to_json and must outlive the data objects of the conversion.
+	*
+	*************************************************************************************************************************************************************************/
+	void set_media_index(const MediaIndex*, const MediaIndex*);
+
+
 	/*************************************************************************************************************************************************************************
 	* This function reads limit file into limits_struct
 	*
 	* Input:
 	*		limits_file_path	wstring									absolute path to testlimits.txt file
 	* Output:
-	*		limits_struct		map<wstring, map<wstring, wstring>>		map container containing limits from testlimits.txt
+	*		limits_struct		LimitsIndex								limits from testlimits.txt, one LimitRecord per parameter
 	*
-	* limits_struct structure holds data in format <parameter_name, <limit_key, limit_value>>, e.g. <ibat_rom, <LSL, 1>>, <ibat_rom, <USL, 3>>
+	* Every line is first read into <limit_key, limit_value>, e.g. <LSL, 1>, <USL, 3>, and then compiled into a LimitRecord (compile_limit).
+	* The compiled limits are cached like parse results of CSV files (set_conversion_cache), an unchanged limits file isn't read again.
+	* If the file can't be opened, the message is written to the log stream and runtime_error is thrown.
 	*
 	* Limits file is read line by line and split on ' ' or '\t' into headers_arr and limits_arr.
 	* headers_arr and limits_arr are mapped to each other based on array index (e.g. if LSL's position in headers_array is 4, the
@@ -56,7 +381,7 @@ public:
 	* header was filled with corresponding limit_value
 	*
 	*************************************************************************************************************************************************************************/
-	map <wstring, map <wstring, wstring>> read_limits_file(const wstring&);
+	LimitsIndex read_limits_file(const wstring&);
 
 
 	/*************************************************************************************************************************************************************************
@@ -64,21 +389,21 @@ public:
 	*
 	* Input:
 	*		csv_files		vector<wstring>						vector of strings containing paths to csv files to be converted
-	*		limits_struct	map<wstring, map<wstring, wstring>>	structure containing limits for test values
+	*		limits_struct	LimitsIndex								compiled limits for test values
 	*		configs_struct	map<wstring, wstring>					structure containing configurations
 	*		json_path		wstring								path to store final JSON file
 	* Output:
 	*		res				bool								whether JSON construction was successful or not
 	*
 	* Internal variables explanation
-	*	cond_str			wstring												combination of conditions for given test value
-	*   key_cond_str		wstring												parameter name + cond_str to keep conditions for each param separately to avoid condition repetition
+	*	cond_str			ConditionHash										combination of conditions for given test value (condition values, then username, basic_type,
+	*																						product_sales_code, product_design_step, package and dut_id)
+	*   key_cond_str		ConditionHash										cond_str + parameter name to keep conditions for each param separately to avoid condition repetition
 	*	common_meta_data	map<wstring, wstring>									stores common_meta_data as <key, value>, e.g. <username, Ali Ganbarov>
-	*	unique_params		map <wstring, int>									mapping for each unique param and test number, e.g. <ibat_rom, 123>
-	***	meta_data			map <wstring, wstring>								stores meta_data of each data object as <key, value>, e.g. <cond_vio, 5>
-	***	payload				map <wstring, wstring>								stores payload of each data object as <key, value>, e.g. <ibat_rom, 1.2345>
-	*	internal_json		map <wstring, map<wstring, map<wstring, wstring>>>		stores data in format map<key_cond_str, map<type, map_of_type<key, value>>> where type = payload or meta_data
-	*	data_objects		vector<map<wstring, map<wstring, wstring>>>			final version of all data_objects, similar to internal_json
+	*	unique_params		TestNumberRegistry									mapping for each unique param and test number, e.g. <ibat_rom, 123>
+	***	meta_data			RowMetaData											stores conditions and cond_link_* of current row, e.g. <cond_VIO, 5>, shared by all data objects of the row
+	*	internal_json		vector<pair<size_t, DataObject>>					stores <out cell index, data object> per key_cond_str, found by a ConditionIndex
+	*	data_objects		vector<DataObject>									final version of all data_objects, similar to internal_json
 	*
 	* #meta lines are used to get username, basic_type, product_design_step and product_sales_code for meta and common_meta data
 	*
@@ -87,30 +412,55 @@ public:
 	*
 	* If limits_struct contains limit for the given parameter, the limit_object and test_number are read from limit
 	* for parameters which don't have limit data, hardcoded limits are applied
-	* test_number is generated based on test_number_counter increment and by avoiding overlap with used test numbers from limits (params that have limits)
+	* test_number is generated by unique_params, it never overlaps with test numbers from limits file. With 'TestNumbers: 1' numbers of params without
+	* limits are kept in 50_Report\test_numbers.txt and reused by the next runs
 	* each unique parameter encountered is saved in unique_params as <param_name, test_number>
 	* limit object is added for any parameter only if unique_params doesn't contain that parameter (in order to add one limit object per unique parameter)
 	* test_number for already encountered parameters are taken from unique_params value to keep number consistent among all parameter's values
 	*
 	* internal_json is used to store test values uniquely based on combination of all conditions
-	* combination of all conditions for a given parameter is stored in key_cond_str, so the first key of internal_json is key_cond_str
+	* combination of all conditions for a given parameter is hashed into key_cond_str, which is looked up in a flat hash table (ConditionIndex)
 	* Whenever condition combination is repetated for parameter the key_cond_str will be same for the previous occurences, so adding
-	* data object to internal_json with same key_cond_str will overwrite previous item.
+	* data object to internal_json with same key_cond_str will overwrite previous item (at the position of the first occurrence).
 	* data_objects has same structure as internal_json, but used for storing final version of data_objects
 	* internal_json is copied to data_objects in two cases:
 	*		1) new #meta tag occured. For current version it means that temperature has changed so there definitely will not be repetition of condition combination
 	*		2) end of CSV file. Other CSVs will not have same parameter name, so repetitions are not possible
 	* After copying internal_json to data_objects, it is set to empty map and filled again
 	*
+	* Files are parsed in parallel (parse_csv_file, number of threads from Threads in configs_struct) and merged in file order.
+	* The merge replays all out values of a file to assign test numbers and limit objects exactly like reading the files one after
+	* another, so the JSON is the same for any number of threads. A file which relies on meta data or header rows of a previous file
+	* is parsed again during the merge.
+	* If a file can't be parsed (e.g. invalid unit), its log is written and the error is thrown when the merge reaches the file.
+	* If a conversion cache is set, unchanged files are not parsed at all, their parse results are loaded from the cache. The merge,
+	* limits and common_meta_data are always done again, so testlimits.txt changes don't need a new parse.
+	*
 	* In case of absence of required configuration item, default is used
 	* last item written to json is recipe
 	*
 	* Test or limit values are scaled based on units
 	*
 	*************************************************************************************************************************************************************************/
-	bool csvs_to_json(vector<wstring>, map<wstring, map<wstring, wstring>>, map<wstring, wstring>, wstring, vector<wstring>, vector<wstring>);
+	bool csvs_to_json(vector<wstring>, const LimitsIndex&, map<wstring, wstring>, wstring, vector<wstring>, vector<wstring>);
 
 
-	vector<wstring>get_corresponding_files(vector<wstring>, vector<wstring>, vector<wstring>);
+	/*************************************************************************************************************************************************************************
+	* This function finds png or mat files matching the conditions of an out value
+	*
+	* Input:
+	*		lower_conditions		vector<wstring>			convert_to_lower of parent folder, sample=<dut_id>, <variable>=<value>[, report-picture or report-waveform
+	*		index					MediaIndex				png or mat files, see build_media_index
+	*		pic_path				vector<wstring>			filenames given in the row (Report-Picture or Report-waveform columns)
+	*		candidates				vector<size_t>			buffer for the files named in pic_path, reused between calls
+	* Output:
+	*		matching_files			vector<size_t>			indices into index of matching files in file order
+	*
+	* A file matches if its base filename is in pic_path and the number of conditions found in its lower case path is the number
+	* of conditions in the path ('=' count + 1 for the parent folder).
+	* Only files named in pic_path are looked up in index.files_by_name, so the costs don't grow with the number of files.
+	*
+	*************************************************************************************************************************************************************************/
+	void get_corresponding_files(const vector<wstring>&, const MediaIndex&, const vector<wstring>&, vector<size_t>&, vector<size_t>&);
 };
 
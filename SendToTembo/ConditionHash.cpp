@@ -0,0 +1,77 @@
+#include "ConditionHash.h"
+#include "ConversionCache.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+void ConditionHash::add(wstring_view part) {
+	// hash_bytes mixes in the length, so parts can't run into each other
+	low = ConversionCache::hash_bytes(part.data(), part.size() * sizeof(wchar_t), low);
+	high = ConversionCache::hash_bytes(part.data(), part.size() * sizeof(wchar_t), high ^ 0x5851F42D4C957F2Dull);
+}
+
+size_t ConditionIndex::insert(const ConditionHash& hash, size_t value) {
+	// keep load factor <= 1/2, probing sequences stay short
+	if ((num_used + 1) * 2 > slots.size()) {
+		this->grow();
+	}
+	size_t mask = slots.size() - 1;
+	for (size_t i = (size_t)hash.low & mask; ; i = (i + 1) & mask) {
+		Slot& slot = slots[i];
+		if (slot.value == npos) {
+			slot.hash = hash;
+			slot.value = value;
+			num_used++;
+			return value;
+		}
+		if (slot.hash == hash) {
+			return slot.value;
+		}
+	}
+}
+
+size_t ConditionIndex::find(const ConditionHash& hash) const {
+	if (slots.empty()) {
+		return npos;
+	}
+	size_t mask = slots.size() - 1;
+	for (size_t i = (size_t)hash.low & mask; ; i = (i + 1) & mask) {
+		const Slot& slot = slots[i];
+		if (slot.value == npos) {
+			return npos;
+		}
+		if (slot.hash == hash) {
+			return slot.value;
+		}
+	}
+}
+
+void ConditionIndex::grow() {
+	vector<Slot> old_slots;
+	old_slots.swap(slots);
+	Slot empty_slot;
+	empty_slot.value = npos;
+	slots.assign(old_slots.empty() ? 64 : old_slots.size() * 2, empty_slot);
+	size_t mask = slots.size() - 1;
+	for (const Slot& old_slot : old_slots) {
+		if (old_slot.value == npos) {
+			continue;
+		}
+		size_t i = (size_t)old_slot.hash.low & mask;
+		while (slots[i].value != npos) {
+			i = (i + 1) & mask;
+		}
+		slots[i] = old_slot;
+	}
+}
+
+void ConditionIndex::clear() {
+	slots.clear();
+	num_used = 0;
+}
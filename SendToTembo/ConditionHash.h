@@ -0,0 +1,100 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* 128 bit identity of a combination of conditions (e.g. parameter name + all condition values of a row)
+*
+* Parts are added one by one, every part is hashed with its length, so "a" + "bc" and "ab" + "c" are different combinations.
+* Two independent 64 bit hashes are kept, a collision (which would merge two different combinations) is not expected in practice.
+*
+*************************************************************************************************************************************************************************/
+struct ConditionHash
+{
+	uint64_t low = 0x243F6A8885A308D3ull;
+	uint64_t high = 0x13198A2E03707344ull;
+
+	// adds next part of the combination
+	void add(wstring_view part);
+
+	// copy with one more part, e.g. hash of parameter name and conditions of the row
+	ConditionHash with(wstring_view part) const {
+		ConditionHash combined = *this;
+		combined.add(part);
+		return combined;
+	}
+
+	bool operator==(const ConditionHash& other) const { return low == other.low && high == other.high; }
+	bool operator!=(const ConditionHash& other) const { return !(*this == other); }
+};
+
+
+/*************************************************************************************************************************************************************************
+* Flat hash table from ConditionHash to an index (e.g. position in a vector of data objects)
+*
+* Open addressing with linear probing in a single array, no allocation per entry. ConditionHash is already a hash, so its low bits
+* are used as slot directly. The table grows to keep at most half of the slots used.
+*
+*************************************************************************************************************************************************************************/
+class ConditionIndex
+{
+
+private:
+	struct Slot {
+		ConditionHash hash;
+		size_t value;
+	};
+
+	vector<Slot> slots;
+	size_t num_used = 0;
+
+	void grow();
+
+public:
+	// value of empty slots and result of find for unknown hashes
+	static const size_t npos = (size_t)-1;
+
+
+	/*************************************************************************************************************************************************************************
+	* This function adds a hash to the table, if it isn't there yet
+	*
+	* Input:
+	*		hash		ConditionHash		combination to look up
+	*		value		size_t				value to store if hash is new (e.g. size of the vector the value will be appended to)
+	* Output:
+	*		stored		size_t				value stored for hash, equal to value if hash was added by this call
+	*
+	*************************************************************************************************************************************************************************/
+	size_t insert(const ConditionHash&, size_t);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function looks up a hash
+	*
+	* Input:
+	*		hash		ConditionHash		combination to look up
+	* Output:
+	*		stored		size_t				value stored for hash, npos if hash was never inserted
+	*
+	*************************************************************************************************************************************************************************/
+	size_t find(const ConditionHash&) const;
+
+	size_t size() const { return num_used; }
+	void clear();
+};
+
@@ -0,0 +1,444 @@
+#include "ConversionCache.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+namespace filesys = std::experimental::filesystem;
+
+// first bytes of every entry file
+static const uint64_t entry_magic = 0x31454843414354ull; // "TCACHE1"
+
+void CacheWriter::put(const wstring& value) {
+	this->put((uint64_t)value.size());
+	this->put_raw(value.data(), value.size() * sizeof(wchar_t));
+}
+
+void CacheWriter::put(const string& value) {
+	this->put((uint64_t)value.size());
+	this->put_raw(value.data(), value.size());
+}
+
+void CacheWriter::put(const DataObject& data_object) {
+	this->put((unsigned int)data_object.type);
+	this->put(data_object.test_name);
+	this->put(data_object.test_number);
+	this->put(data_object.row);
+	this->put(data_object.meta_data);
+	this->put(data_object.value);
+	this->put(data_object.raw_data_link);
+	this->put(data_object.comments);
+	this->put(data_object.scale);
+	this->put(data_object.unit);
+	this->put(data_object.lower_limit);
+	this->put(data_object.upper_limit);
+}
+
+void CacheWriter::put(const shared_ptr<const RowMetaData>& row) {
+	// 0 = no row, a new number is followed by the row itself
+	if (!row) {
+		this->put((uint64_t)0);
+		return;
+	}
+	auto written = row_numbers.find(row.get());
+	if (written != row_numbers.end()) {
+		this->put(written->second);
+		return;
+	}
+	uint64_t number = row_numbers.size() + 1;
+	row_numbers[row.get()] = number;
+	this->put(number);
+	this->put(row->dut_id);
+	this->put(row->conds);
+	this->put(row->meta_data);
+}
+
+void CacheWriter::put(const LimitRecord& limit) {
+	this->put(limit.name);
+	this->put(limit.test_number);
+	this->put(limit.test_number_value);
+	this->put(limit.has_test_number_value);
+	this->put(limit.raw_unit);
+	this->put(limit.unit);
+	this->put(limit.scale);
+	this->put(limit.unit_valid);
+	this->put(limit.lower_limit);
+	this->put(limit.upper_limit);
+	this->put(limit.lower_limit_value);
+	this->put(limit.upper_limit_value);
+	this->put(limit.typical_value);
+	this->put(limit.typical);
+	this->put(limit.req_id);
+	this->put(limit.description);
+}
+
+CacheReader::CacheReader(const string& data, StringPool* string_pool) : data(data), string_pool(string_pool) {
+}
+
+void CacheReader::get_raw(void* bytes, size_t size) {
+	if (failed || data.size() - pos < size) {
+		failed = true;
+		memset(bytes, 0, size);
+		return;
+	}
+	memcpy(bytes, data.data() + pos, size);
+	pos += size;
+}
+
+bool CacheReader::check_count(uint64_t count, size_t min_size) {
+	if (failed || count > (data.size() - pos) / min_size) {
+		failed = true;
+		return false;
+	}
+	return true;
+}
+
+void CacheReader::get(wstring& value) {
+	uint64_t length = 0;
+	this->get(length);
+	value.clear();
+	if (!this->check_count(length, sizeof(wchar_t))) {
+		return;
+	}
+	value.resize((size_t)length);
+	this->get_raw(&value[0], (size_t)length * sizeof(wchar_t));
+}
+
+void CacheReader::get(string& value) {
+	uint64_t length = 0;
+	this->get(length);
+	value.clear();
+	if (!this->check_count(length, 1)) {
+		return;
+	}
+	value.resize((size_t)length);
+	this->get_raw(&value[0], (size_t)length);
+}
+
+void CacheReader::get(PooledString& value) {
+	string text;
+	this->get(text);
+	value = string_pool != nullptr ? string_pool->intern(text) : StringPool::empty();
+}
+
+void CacheReader::get(DataObject& data_object) {
+	unsigned int type = 0;
+	this->get(type);
+	data_object.type = type == DataObject::LIMIT ? DataObject::LIMIT : DataObject::VALUE;
+	this->get(data_object.test_name);
+	this->get(data_object.test_number);
+	this->get(data_object.row);
+	this->get(data_object.meta_data);
+	this->get(data_object.value);
+	this->get(data_object.raw_data_link);
+	this->get(data_object.comments);
+	this->get(data_object.scale);
+	this->get(data_object.unit);
+	this->get(data_object.lower_limit);
+	this->get(data_object.upper_limit);
+}
+
+void CacheReader::get(shared_ptr<const RowMetaData>& row) {
+	uint64_t number = 0;
+	this->get(number);
+	row.reset();
+	if (number == 0 || failed) {
+		return;
+	}
+	if (number <= rows.size()) {
+		row = rows[(size_t)number - 1];
+		return;
+	}
+	// rows are numbered in the order they were written
+	if (number != rows.size() + 1) {
+		failed = true;
+		return;
+	}
+	shared_ptr<RowMetaData> new_row = make_shared<RowMetaData>();
+	this->get(new_row->dut_id);
+	this->get(new_row->conds);
+	this->get(new_row->meta_data);
+	rows.push_back(new_row);
+	row = new_row;
+}
+
+void CacheReader::get(LimitRecord& limit) {
+	this->get(limit.name);
+	this->get(limit.test_number);
+	this->get(limit.test_number_value);
+	this->get(limit.has_test_number_value);
+	this->get(limit.raw_unit);
+	this->get(limit.unit);
+	this->get(limit.scale);
+	this->get(limit.unit_valid);
+	this->get(limit.lower_limit);
+	this->get(limit.upper_limit);
+	this->get(limit.lower_limit_value);
+	this->get(limit.upper_limit_value);
+	this->get(limit.typical_value);
+	this->get(limit.typical);
+	this->get(limit.req_id);
+	this->get(limit.description);
+}
+
+void ContentHash::add_word(uint64_t word) {
+	// same steps as hash_bytes
+	hash ^= word * 0x9E3779B97F4A7C15ull;
+	hash = ((hash << 31) | (hash >> 33)) * 0xC2B2AE3D27D4EB4Full;
+}
+
+void ContentHash::add(const void* data, size_t data_size) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	size += data_size;
+	// complete the word of the previous part first
+	while (tail_size > 0 && tail_size < 8 && data_size > 0) {
+		tail[tail_size++] = *bytes++;
+		data_size--;
+	}
+	if (tail_size == 8) {
+		uint64_t word;
+		memcpy(&word, tail, 8);
+		this->add_word(word);
+		tail_size = 0;
+	}
+	for (; data_size >= 8; bytes += 8, data_size -= 8) {
+		uint64_t word;
+		memcpy(&word, bytes, 8);
+		this->add_word(word);
+	}
+	if (data_size > 0) {
+		memcpy(tail + tail_size, bytes, data_size);
+		tail_size += data_size;
+	}
+}
+
+uint64_t ContentHash::value() const {
+	ContentHash last = *this;
+	if (last.tail_size > 0) {
+		uint64_t word = 0;
+		memcpy(&word, last.tail, last.tail_size);
+		last.add_word(word);
+	}
+	// final mix with the size, so every input bit affects every output bit
+	uint64_t result = last.hash ^ (size * 0x9E3779B97F4A7C15ull);
+	result ^= result >> 33;
+	result *= 0xFF51AFD7ED558CCDull;
+	result ^= result >> 33;
+	result *= 0xC4CEB9FE1A85EC53ull;
+	result ^= result >> 33;
+	return result;
+}
+
+ConversionCache::ConversionCache(const wstring& cache_folder) : cache_folder(cache_folder) {
+	if (cache_folder.empty()) {
+		return;
+	}
+	error_code ec;
+	filesys::create_directories(cache_folder, ec);
+	enabled = !ec && filesys::is_directory(cache_folder, ec);
+}
+
+ConversionCache::~ConversionCache() {
+}
+
+wstring ConversionCache::entry_path(const wstring& kind, const wstring& input_file) const {
+	uint64_t hash = hash_string(input_file, hash_string(kind));
+	const wchar_t* hex = L"0123456789abcdef";
+	wstring name(16, L'0');
+	for (int i = 15; i >= 0; i--) {
+		name[i] = hex[hash & 0xF];
+		hash >>= 4;
+	}
+	return cache_folder + L"\\" + name + L".cache";
+}
+
+bool ConversionCache::write_entry(const wstring& kind, const wstring& input_file, uint64_t settings_hash, uint64_t file_size, int64_t file_time,
+	uint64_t content_hash, const string& payload) const {
+	CacheWriter header;
+	header.put(entry_magic ^ format_version);
+	header.put(kind);
+	header.put(input_file);
+	header.put(settings_hash);
+	header.put(file_size);
+	header.put((uint64_t)file_time);
+	header.put(content_hash);
+
+	// write next to the entry and rename, readers see either the old or the new entry. If the old entry can't be replaced
+	// directly, it is removed first and readers meanwhile find no entry (parse again)
+	wstring path = this->entry_path(kind, input_file);
+	wstring temp_path = path + L".tmp";
+	{
+		ofstream out(temp_path, ios::out | ios::binary | ios::trunc);
+		if (!out.is_open()) {
+			return false;
+		}
+		out.write(header.get_data().data(), header.get_data().size());
+		out.write(payload.data(), payload.size());
+		if (!out) {
+			return false;
+		}
+	}
+	error_code ec;
+	filesys::rename(temp_path, path, ec);
+	if (ec) {
+		filesys::remove(path, ec);
+		filesys::rename(temp_path, path, ec);
+	}
+	if (ec) {
+		filesys::remove(temp_path, ec);
+		return false;
+	}
+	return true;
+}
+
+bool ConversionCache::load(const wstring& kind, const wstring& input_file, uint64_t settings_hash, string& payload) const {
+	if (!enabled) {
+		return false;
+	}
+	error_code ec;
+	uint64_t file_size = filesys::file_size(input_file, ec);
+	if (ec) {
+		return false;
+	}
+	int64_t file_time = filesys::last_write_time(input_file, ec).time_since_epoch().count();
+	if (ec) {
+		return false;
+	}
+
+	// read whole entry
+	string entry;
+	{
+		ifstream in(this->entry_path(kind, input_file), ios::in | ios::binary);
+		if (!in.is_open()) {
+			return false;
+		}
+		entry.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+	}
+
+	CacheReader header(entry, nullptr);
+	uint64_t magic = 0;
+	wstring entry_kind;
+	wstring entry_input_file;
+	uint64_t entry_settings_hash = 0;
+	uint64_t entry_file_size = 0;
+	uint64_t entry_file_time = 0;
+	uint64_t entry_content_hash = 0;
+	header.get(magic);
+	header.get(entry_kind);
+	header.get(entry_input_file);
+	header.get(entry_settings_hash);
+	header.get(entry_file_size);
+	header.get(entry_file_time);
+	header.get(entry_content_hash);
+	if (!header.good() || magic != (entry_magic ^ format_version) || entry_kind != kind || entry_input_file != input_file ||
+		entry_settings_hash != settings_hash || entry_file_size != file_size) {
+		return false;
+	}
+
+	payload = entry.substr(header.position());
+	if ((int64_t)entry_file_time != file_time) {
+		// touched or copied, only the content decides
+		uint64_t content_hash = 0;
+		if (!hash_file(input_file, content_hash) || content_hash != entry_content_hash) {
+			payload.clear();
+			return false;
+		}
+		this->write_entry(kind, input_file, settings_hash, file_size, file_time, content_hash, payload);
+	}
+	return true;
+}
+
+CacheFileState ConversionCache::file_state(const wstring& input_file) {
+	CacheFileState state;
+	error_code ec;
+	state.size = filesys::file_size(input_file, ec);
+	if (ec) {
+		return state;
+	}
+	state.time = filesys::last_write_time(input_file, ec).time_since_epoch().count();
+	state.valid = !ec;
+	return state;
+}
+
+bool ConversionCache::store(const wstring& kind, const wstring& input_file, uint64_t settings_hash, const CacheFileState& state, const string& payload) const {
+	if (!enabled || !state.valid || state.content.bytes() != state.size) {
+		return false;
+	}
+	// changed while it was parsed, the payload may belong to neither version
+	CacheFileState current_state = file_state(input_file);
+	if (!current_state.valid || current_state.size != state.size || current_state.time != state.time) {
+		return false;
+	}
+	return this->write_entry(kind, input_file, settings_hash, state.size, state.time, state.content.value(), payload);
+}
+
+uint64_t ConversionCache::hash_bytes(const void* data, size_t size, uint64_t seed) {
+	const uint64_t prime_1 = 0x9E3779B97F4A7C15ull;
+	const uint64_t prime_2 = 0xC2B2AE3D27D4EB4Full;
+	const unsigned char* bytes = (const unsigned char*)data;
+	uint64_t hash = seed ^ (size * prime_1);
+	size_t i = 0;
+	// 8 bytes per step
+	for (; i + 8 <= size; i += 8) {
+		uint64_t word;
+		memcpy(&word, bytes + i, 8);
+		hash ^= word * prime_1;
+		hash = ((hash << 31) | (hash >> 33)) * prime_2;
+	}
+	if (i < size) {
+		uint64_t word = 0;
+		memcpy(&word, bytes + i, size - i);
+		hash ^= word * prime_1;
+		hash = ((hash << 31) | (hash >> 33)) * prime_2;
+	}
+	// final mix, so every input bit affects every output bit
+	hash ^= hash >> 33;
+	hash *= 0xFF51AFD7ED558CCDull;
+	hash ^= hash >> 33;
+	hash *= 0xC4CEB9FE1A85EC53ull;
+	hash ^= hash >> 33;
+	return hash;
+}
+
+uint64_t ConversionCache::hash_string(const wstring& text, uint64_t seed) {
+	return hash_bytes(text.data(), text.size() * sizeof(wchar_t), seed);
+}
+
+bool ConversionCache::hash_file(const wstring& path, uint64_t& hash) {
+	ifstream in(path, ios::in | ios::binary);
+	if (!in.is_open()) {
+		return false;
+	}
+	const size_t block_size = 1 << 20;
+	vector<char> block(block_size);
+	ContentHash content;
+	while (in) {
+		in.read(block.data(), block_size);
+		size_t read = (size_t)in.gcount();
+		if (read == 0) {
+			break;
+		}
+		content.add(block.data(), read);
+	}
+	hash = content.value();
+	return !in.bad();
+}
+
+uint64_t ConversionCache::hash_configs(const map<wstring, wstring>& configs_struct) {
+	uint64_t hash = 0;
+	for (const auto& config : configs_struct) {
+		if (config.first == L"Threads" || config.first == L"Cache" || config.first == L"StreamingSize" ||
+			config.first == L"UploadThreads" || config.first == L"StagingArea" || config.first == L"Trace" || config.first == L"TestNumbers" ||
+			config.first == L"JsonFormat") {
+			continue;
+		}
+		hash = hash_string(config.first, hash);
+		hash = hash_string(config.second, hash);
+	}
+	return hash;
+}
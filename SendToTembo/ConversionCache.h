@@ -0,0 +1,310 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <fstream>
+#include <experimental/filesystem>
+#include "DataObject.h"
+#include "ConditionHash.h"
+#include "LimitsIndex.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* Binary payload of a conversion cache entry
+*
+* Values are appended as raw bytes, strings as length + wchar_t (or char for UTF-8 string). Entries are only read back by the same converter version on the same
+* machine, so there is no conversion of byte order or wchar_t size.
+* vector, map and pair of supported types are written element by element.
+* Row meta data shared by several data objects is written once, later objects of the row only refer to it by number.
+*
+*************************************************************************************************************************************************************************/
+class CacheWriter
+{
+
+private:
+	string data;
+	// number (1, 2, ...) of every row meta data written so far
+	map<const RowMetaData*, uint64_t> row_numbers;
+
+	void put_raw(const void* bytes, size_t size) { data.append((const char*)bytes, size); }
+
+public:
+	const string& get_data() const { return data; }
+
+	void put(uint64_t value) { this->put_raw(&value, sizeof(value)); }
+	void put(int value) { this->put_raw(&value, sizeof(value)); }
+	void put(unsigned int value) { this->put_raw(&value, sizeof(value)); }
+	void put(bool value) { this->put((unsigned int)value); }
+	void put(double value) { this->put_raw(&value, sizeof(value)); }
+	void put(const wstring& value);
+	void put(const string& value);
+	void put(PooledString value) { this->put(*value); }
+	void put(const DataObject& data_object);
+	void put(const shared_ptr<const RowMetaData>& row);
+	void put(const ConditionHash& hash) { this->put(hash.low); this->put(hash.high); }
+	void put(const LimitRecord& limit);
+
+	template<class A, class B> void put(const pair<A, B>& value) {
+		this->put(value.first);
+		this->put(value.second);
+	}
+	template<class T> void put(const vector<T>& values) {
+		this->put((uint64_t)values.size());
+		for (const T& value : values) {
+			this->put(value);
+		}
+	}
+	template<class K, class V> void put(const map<K, V>& values) {
+		this->put((uint64_t)values.size());
+		for (const auto& value : values) {
+			this->put(value.first);
+			this->put(value.second);
+		}
+	}
+};
+
+
+/*************************************************************************************************************************************************************************
+* Reads values in the order CacheWriter wrote them
+*
+* Reading past the end or a size larger than the rest of the payload marks the reader as failed, all values read afterwards are
+* empty. Pooled strings are interned in the given pool.
+* Data objects which shared their row meta data when written share it again.
+*
+*************************************************************************************************************************************************************************/
+class CacheReader
+{
+
+private:
+	const string& data;
+	size_t pos = 0;
+	bool failed = false;
+	StringPool* string_pool;
+	// row meta data read so far, by number - 1
+	vector<shared_ptr<const RowMetaData>> rows;
+
+	void get_raw(void* bytes, size_t size);
+	// checks that count elements of at least min_size bytes can still follow
+	bool check_count(uint64_t count, size_t min_size);
+
+public:
+	CacheReader(const string& data, StringPool* string_pool);
+
+	bool good() const { return !failed; }
+	size_t position() const { return pos; }
+
+	void get(uint64_t& value) { this->get_raw(&value, sizeof(value)); }
+	void get(int& value) { this->get_raw(&value, sizeof(value)); }
+	void get(unsigned int& value) { this->get_raw(&value, sizeof(value)); }
+	void get(bool& value) { unsigned int raw = 0; this->get(raw); value = raw != 0; }
+	void get(double& value) { this->get_raw(&value, sizeof(value)); }
+	void get(wstring& value);
+	void get(string& value);
+	void get(PooledString& value);
+	void get(DataObject& data_object);
+	void get(shared_ptr<const RowMetaData>& row);
+	void get(ConditionHash& hash) { this->get(hash.low); this->get(hash.high); }
+	void get(LimitRecord& limit);
+
+	template<class A, class B> void get(pair<A, B>& value) {
+		this->get(value.first);
+		this->get(value.second);
+	}
+	template<class T> void get(vector<T>& values) {
+		uint64_t count = 0;
+		this->get(count);
+		values.clear();
+		if (!this->check_count(count, 1)) {
+			return;
+		}
+		values.resize((size_t)count);
+		for (T& value : values) {
+			this->get(value);
+		}
+	}
+	template<class K, class V> void get(map<K, V>& values) {
+		uint64_t count = 0;
+		this->get(count);
+		values.clear();
+		if (!this->check_count(count, 1)) {
+			return;
+		}
+		for (uint64_t i = 0; i < count && !failed; i++) {
+			K key;
+			V value;
+			this->get(key);
+			this->get(value);
+			values.emplace(move(key), move(value));
+		}
+	}
+};
+
+
+/*************************************************************************************************************************************************************************
+* Hash of the content of a file (64 bit, not cryptographic)
+*
+* Bytes can be added in parts of any size, the hash only depends on the whole byte sequence. LineReader adds the bytes it reads
+* (LineReader::open), so a parsed file doesn't have to be read a second time to hash it for the cache.
+*
+*************************************************************************************************************************************************************************/
+class ContentHash
+{
+
+private:
+	uint64_t hash = 0;
+	uint64_t size = 0;
+	// bytes of an incomplete 8 byte word
+	unsigned char tail[8];
+	size_t tail_size = 0;
+
+	void add_word(uint64_t word);
+
+public:
+	void add(const void* data, size_t size);
+	uint64_t bytes() const { return size; }
+	uint64_t value() const;
+};
+
+
+// size and modification time of an input file before it was parsed, content is hashed while it is parsed
+struct CacheFileState
+{
+	bool valid = false;
+	uint64_t size = 0;
+	int64_t time = 0;
+	ContentHash content;
+};
+
+
+/*************************************************************************************************************************************************************************
+* Persistent cache of per file conversion results
+*
+* Every input file has one entry file in cache_folder, named by a hash of kind and input path. An entry stores the settings hash, size,
+* modification time and content hash of the input file together with the payload (parse results written by CacheWriter).
+* An entry is used if settings hash and size are the same and either the modification time or the content hash is the same. If only
+* the modification time changed (e.g. file copied again), the entry is updated with the new time.
+* An entry describes the file as it was before parsing (file_state), a file which changed while it was parsed isn't stored.
+* Entries are written to a temporary file first and renamed, so an interrupted run never leaves a half written entry.
+* Different input files can be loaded and stored from different threads at the same time.
+*
+*************************************************************************************************************************************************************************/
+class ConversionCache
+{
+
+private:
+	wstring cache_folder;
+	bool enabled = false;
+
+	// version of entry and payload layout, entries of other versions are ignored
+	static const uint64_t format_version = 7;
+
+	wstring entry_path(const wstring& kind, const wstring& input_file) const;
+	bool write_entry(const wstring& kind, const wstring& input_file, uint64_t settings_hash, uint64_t file_size, int64_t file_time,
+		uint64_t content_hash, const string& payload) const;
+
+public:
+
+	/*************************************************************************************************************************************************************************
+	* This function opens the cache in the given folder
+	*
+	* Input:
+	*		cache_folder		wstring			folder of the entry files, created if it doesn't exist
+	*
+	* If cache_folder is empty or can't be created the cache stays disabled, load never hits and store does nothing.
+	*
+	*************************************************************************************************************************************************************************/
+	ConversionCache(const wstring&);
+	~ConversionCache();
+
+	bool is_enabled() const { return enabled; }
+
+
+	/*************************************************************************************************************************************************************************
+	* This function reads the cached payload of an input file
+	*
+	* Input:
+	*		kind				wstring			kind of conversion (e.g. csv, eff), same input file can have an entry per kind
+	*		input_file			wstring			path to the input file
+	*		settings_hash		uint64_t		hash of all settings the conversion depends on
+	* Output:
+	*		payload				string			payload given to store
+	*		res					bool			whether a valid entry was found
+	*
+	*************************************************************************************************************************************************************************/
+	bool load(const wstring&, const wstring&, uint64_t, string&) const;
+
+
+	/*************************************************************************************************************************************************************************
+	* This function returns size and modification time of an input file, taken before it is parsed
+	*
+	* Input:
+	*		input_file			wstring			path to the input file
+	* Output:
+	*		state				CacheFileState	size and time, valid is false if the file can't be found. content is empty, the parser adds to it
+	*
+	*************************************************************************************************************************************************************************/
+	static CacheFileState file_state(const wstring&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function stores the payload of an input file
+	*
+	* Input:
+	*		kind				wstring			kind of conversion (e.g. csv, eff)
+	*		input_file			wstring			path to the input file
+	*		settings_hash		uint64_t		hash of all settings the conversion depends on
+	*		state				CacheFileState	file_state before parsing, with the hash of all bytes the parser read
+	*		payload				string			conversion results, e.g. CacheWriter::get_data()
+	* Output:
+	*		res					bool			whether entry was written
+	*
+	* Nothing is stored if the file wasn't read completely or its size or modification time changed since state was taken.
+	*
+	*************************************************************************************************************************************************************************/
+	bool store(const wstring&, const wstring&, uint64_t, const CacheFileState&, const string&) const;
+
+
+	/*************************************************************************************************************************************************************************
+	* These functions hash bytes, wstrings and whole files (64 bit, not cryptographic)
+	*
+	* Input:
+	*		data, size / text / path		bytes, wstring or file to hash
+	*		seed							uint64_t		previous hash, to chain several values into one hash
+	* Output:
+	*		hash							uint64_t		hash value, hash_file returns false if the file can't be read
+	*
+	*************************************************************************************************************************************************************************/
+	static uint64_t hash_bytes(const void*, size_t, uint64_t seed = 0);
+	static uint64_t hash_string(const wstring&, uint64_t seed = 0);
+	static bool hash_file(const wstring&, uint64_t&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function hashes the configurations a conversion depends on
+	*
+	* Input:
+	*		configs_struct		map<wstring, wstring>		configurations
+	* Output:
+	*		hash				uint64_t					hash of all keys and values except Threads, Cache, StreamingSize, UploadThreads, StagingArea,
+	*																Trace, TestNumbers and JsonFormat, which don't change results
+	*
+	*************************************************************************************************************************************************************************/
+	static uint64_t hash_configs(const map<wstring, wstring>&);
+};
+
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <memory>
+#include "StringPool.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* metaData shared by all value objects of a test row
+*
+* Conditions and meta fields only depend on the row, so the objects of a row point to one RowMetaData instead of each having a
+* copy. Once the first object of a row got it, it is not changed anymore.
+*
+*************************************************************************************************************************************************************************/
+struct RowMetaData
+{
+	PooledString dut_id = StringPool::empty();
+	// cond_* fields, e.g. <cond_VIO, 5>, <cond_link_raw_data, file:///...>
+	vector<pair<PooledString, PooledString>> conds;
+	// meta fields of the row, e.g. <package, PG-TSDSO-14>
+	vector<pair<PooledString, PooledString>> meta_data;
+
+
+	// resets all fields, buffers keep their capacity for the next row
+	void clear() {
+		dut_id = StringPool::empty();
+		conds.clear();
+		meta_data.clear();
+	}
+
+	// sets a cond_* field, replaces value if key already exists (keys must come from the same pool)
+	void set_cond(PooledString key, PooledString cond_value) {
+		for (auto& cond : conds) {
+			if (cond.first == key) {
+				cond.second = cond_value;
+				return;
+			}
+		}
+		conds.push_back(make_pair(key, cond_value));
+	}
+
+	// sets a meta field, replaces value if key already exists
+	void set_meta(PooledString key, PooledString meta_value) {
+		for (auto& field : meta_data) {
+			if (field.first == key) {
+				field.second = meta_value;
+				return;
+			}
+		}
+		meta_data.push_back(make_pair(key, meta_value));
+	}
+};
+
+
+/*************************************************************************************************************************************************************************
+* Single Tembo data object (test value or limit) as written into dataObjects by json_writer
+*
+* Well known fields have their own slot, everything else is kept as <key, value> pairs in the order it was added.
+* Objects are stored by value in vector<DataObject>, so there is no map node per field anymore.
+* Keys and values repeated over many objects (conditions, cond_link_*, user_name, ...) are handles into the StringPool
+* of the reader, only test value, test number and limit payload are owned by the object. They are kept as UTF-8 the way they are
+* written to the JSON, mostly short ASCII numbers which fit into the string itself without an allocation.
+*
+* metaData of value objects:	test_name, test_number, data_object_type = value, dut_id, conds and meta fields of row, meta_data
+* payload of value objects:		<test_name, value>, raw_data_link, comments
+* metaData of limit objects:	meta_data (common meta data, reqID, description, ...), test_number, parameter_name = test_name,
+*								data_object_type = limit
+* payload of limit objects:		scale (only if set), unit, lower_limit, upper_limit
+*
+*************************************************************************************************************************************************************************/
+struct DataObject
+{
+	enum Type { VALUE, LIMIT };
+
+	Type type = VALUE;
+	PooledString test_name = StringPool::empty();
+	// UTF-8
+	string test_number;
+	// dut_id, conds and meta fields of the test row of value objects, shared with the other objects of the row
+	shared_ptr<const RowMetaData> row;
+	// remaining metaData fields of this object, e.g. <rddf_tc_id, ...>, written after the ones of row
+	vector<pair<PooledString, PooledString>> meta_data;
+
+	// payload of value objects, value is UTF-8
+	string value;
+	// <type, filename>, type is PNG or MAT
+	vector<pair<PooledString, PooledString>> raw_data_link;
+	vector<PooledString> comments;
+
+	// payload of limit objects, UTF-8
+	string scale;
+	string unit;
+	string lower_limit;
+	string upper_limit;
+
+
+	// resets all fields, buffers keep their capacity for the next row
+	void clear() {
+		type = VALUE;
+		test_name = StringPool::empty();
+		test_number.clear();
+		row.reset();
+		meta_data.clear();
+		value.clear();
+		raw_data_link.clear();
+		comments.clear();
+		scale.clear();
+		unit.clear();
+		lower_limit.clear();
+		upper_limit.clear();
+	}
+
+	// row of value objects, an empty one if there is none
+	const RowMetaData& get_row() const {
+		static const RowMetaData no_row;
+		return row ? *row : no_row;
+	}
+
+	// sets a metaData field of this object, replaces value if key already exists
+	void set_meta(PooledString key, PooledString meta_value) {
+		for (auto& field : meta_data) {
+			if (field.first == key) {
+				field.second = meta_value;
+				return;
+			}
+		}
+		meta_data.push_back(make_pair(key, meta_value));
+	}
+};
+
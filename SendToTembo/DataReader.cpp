@@ -23,10 +23,10 @@ map <wstring, wstring> DataReader::read_config_file(const wstring& config_file_p
 	map <wstring, wstring> configs_struct;
 	wifstream inf(config_file_path);
 	if (!inf) {
-		wcout << L"Couldn't read config file: " << config_file_path << endl;
-		exit(1);
+		*this->log_stream << L"Couldn't read config file: " << config_file_path << endl;
+		throw runtime_error("couldn't read config file " + LineReader::encode(config_file_path));
 	}
-	cout << "CONFIG READER: " << endl;
+	*this->log_stream << "CONFIG READER: " << endl;
 	while (inf) {
 		wstring strInp;
 		// read line
@@ -64,6 +64,9 @@ map<wstring, wstring> DataReader::setup_configurations(map<wstring, wstring> con
 	wstring email = L"syed.ghaznavi@infineon.com"; // by default
 	wstring api_id_perl = L"";
 	wstring username = L"";
+	wstring threads = L"0";
+	wstring streaming_size = L"512";
+	wstring test_numbers = L"0";
 	bool default_email = true;
 	for (map<wstring, wstring>::value_type& config : configs_struct) {
 		wstring key = this->convert_to_lower(config.first);
@@ -86,10 +89,19 @@ map<wstring, wstring> DataReader::setup_configurations(map<wstring, wstring> con
 		else if (key == L"username") {
 			username = config.second;
 		}
+		else if (key == L"threads") {
+			threads = config.second;
+		}
+		else if (key == L"streamingsize") {
+			streaming_size = config.second;
+		}
+		else if (key == L"testnumbers") {
+			test_numbers = config.second;
+		}
 	}
 	if (default_email) {
-		wcout << endl << L"No configuration for email found in 'Config_Tembo.txt'" << endl;
-		wcout << L"Default email: " << email << endl;
+		*this->log_stream << endl << L"No configuration for email found in 'Config_Tembo.txt'" << endl;
+		*this->log_stream << L"Default email: " << email << endl;
 	}
 	
 	
@@ -100,42 +112,89 @@ map<wstring, wstring> DataReader::setup_configurations(map<wstring, wstring> con
 	final_configs[L"Email"] = email;
 	final_configs[L"api_id_perl"] = api_id_perl;
 	final_configs[L"Username"] = username;
+	final_configs[L"Threads"] = threads;
+	final_configs[L"StreamingSize"] = streaming_size;
+	final_configs[L"TestNumbers"] = test_numbers;
 	if (is_csv) {
 		final_configs[L"ReportName"] = report_name;
-		wcout << endl << L"CSV Configurations" << endl;
-		wcout << L"Report name: " << report_name << endl;
+		*this->log_stream << endl << L"CSV Configurations" << endl;
+		*this->log_stream << L"Report name: " << report_name << endl;
 	}
 	else {
-		wcout << endl << L"EFF Configurations" << endl;
+		*this->log_stream << endl << L"EFF Configurations" << endl;
 	}
-	wcout << L"Project name: " << project_name << endl << L"Report template: " << report_template << endl;
-	wcout << L"Email: " << email << endl;
-	wcout << endl;
+	*this->log_stream << L"Project name: " << project_name << endl << L"Report template: " << report_template << endl;
+	*this->log_stream << L"Email: " << email << endl;
+	*this->log_stream << endl;
 
 	return final_configs;
 }
 
 bool DataReader::json_writer(map<wstring, wstring> header, map<wstring, wstring> common_meta_data, 
-	vector<map<wstring, map<wstring, wstring>>> *data_objects, wstring json_path, wstring recipe_payload) {
-	typedef std::chrono::high_resolution_clock clock;
-	typedef std::chrono::duration<float, std::milli> mil;
+	vector<DataObject> *data_objects, wstring json_path, wstring recipe_payload) {
 	int c{};
-	chrono::time_point<chrono::steady_clock> t0, t1;
 
-	// open file, write to file by chunks
-	wstring json_chunk;
-	wofstream out(json_path);
+	// open file and write everything before the data objects
+	TraceSpan span(this->tracer, L"write", L"json_writer");
+	span.arg(L"file", json_path);
+	span.counter(L"data_objects", data_objects->size());
+	JsonWriter out;
+	if (!this->begin_json(out, header, common_meta_data, json_path)) {
+		return false;
+	}
+
+	// calculate step size for progress bar
+	int progress_step{};
+	int initial_size = data_objects->size();
+	if (data_objects->size() < 100) {
+		progress_step = 1;
+	}
+	else {
+		progress_step = ceil(data_objects->size() / 100.0);
+	}
+	// write data objects
+	*this->log_stream << data_objects->size() << L" data objects" << endl;
+	while(!data_objects->empty()) {
+		DataObject data_object = move(data_objects->back());
+		data_objects->pop_back();
+		this->write_data_object(out, data_object);
+
+		// update progress bar every {progress_steps}
+		if (++c % progress_step == 0) {
+			*this->log_stream << '\r' << this->progress_bar(c, initial_size, progress_step);
+		}
+	}
+	// update progress bar for final chunk
+	*this->log_stream << '\r' << this->progress_bar(c, initial_size, progress_step);
+
+	bool res = this->end_json(out, recipe_payload, json_path);
+	span.counter(L"bytes", out.bytes_written());
+	return res;
+}
+
+bool DataReader::begin_json(JsonWriter& out, map<wstring, wstring> header, map<wstring, wstring> common_meta_data, wstring json_path) {
+	// open file, buffered writer flushes to file by itself
+	out.set_compact(this->compact_json);
+	if (!out.open(json_path)) {
+		*this->log_stream << L"Couldn't write JSON file: " << json_path << endl;
+		return false;
+	}
 
-	wcout << L"Writing JSON.." << endl;
+	*this->log_stream << L"Writing JSON.." << endl;
 
 	// open json {
-	json_chunk = L"{\n";
+	out.begin_object();
 	// write header
-	json_chunk += L"\"header\":\n\t{\n\t\t\"version\":\"1.0.1\"\n\t},\n";
+	out.key(L"header");
+	out.begin_object();
+	out.key(L"version");
+	out.string_value(L"1.0.1");
+	out.end_object();
 
 	// write common_meta_data
 	// open commonMetaData tag
-	json_chunk += L"\"commonMetaData\":\n\t{";
+	out.key(L"commonMetaData");
+	out.begin_object();
 	// write common_meta_data items
 	for (map<wstring, wstring>::value_type& com_meta : common_meta_data) {
 		// try to convert to integer wherever possible
@@ -143,10 +202,10 @@ bool DataReader::json_writer(map<wstring, wstring> header, map<wstring, wstring>
 		wstring str_second;
 		wistringstream iss(com_meta.second);
 		iss >> dec >> second;
-		json_chunk += L"\n\t\t";
+		out.key(com_meta.first);
 		if (iss.fail() || com_meta.first == L"ts_data_created") {
 			// couldn't convert, write as wstring
-			json_chunk = json_chunk + L"\"" + com_meta.first + L"\":\"" + com_meta.second + L"\",";
+			out.string_value(com_meta.second);
 		}
 		else {
 			// success write as int
@@ -156,221 +215,153 @@ bool DataReader::json_writer(map<wstring, wstring> header, map<wstring, wstring>
 			if (str_second[str_second.size() - 1] == '.') {
 				str_second = this->strremove(str_second, '.');
 			}
-			json_chunk = json_chunk + L"\"" + com_meta.first + L"\":" + str_second + L",";
+			out.raw_value(str_second);
 		}
 
 	}
-	// remove last ,
-	json_chunk = json_chunk.substr(0, json_chunk.size() - 1);
 	// close commonMetaData tag
-	json_chunk += L"\n\t},\n";
+	out.end_object();
 
-	// write to file and reset
-	out << json_chunk;
-	json_chunk = L"";
+	// open dataObjects tag
+	out.key(L"dataObjects");
+	out.begin_array();
 
-	// calculate step size for progress bar
-	int progress_step{};
-	int initial_size = data_objects->size();
-	if (data_objects->size() < 100) {
-		progress_step = 1;
+	return true;
+}
+
+void DataReader::write_data_object(JsonWriter& out, const DataObject& data_object) {
+	// open item tag {
+	out.begin_object();
+
+	// Writing everything as string to save precision for big number conversion to and from scientific version
+	// e.g. test_number = 12345678 as number becomes 1.23e6, which converts back to number as 1230000
+	out.key(L"metaData");
+	out.begin_object();
+	if (data_object.type == DataObject::VALUE) {
+		out.key(L"test_name");
+		out.string_value(*data_object.test_name);
+		out.key(L"test_number");
+		out.string_value(data_object.test_number);
+		out.key(L"data_object_type");
+		out.string_value(L"value");
+		// fields of the row are shared with the other objects of the row, own fields follow
+		const RowMetaData& row = data_object.get_row();
+		out.key(L"dut_id");
+		out.string_value(*row.dut_id);
+		for (auto& cond : row.conds) {
+			out.key(*cond.first);
+			out.string_value(*cond.second);
+		}
+		for (auto& field : row.meta_data) {
+			out.key(*field.first);
+			out.string_value(*field.second);
+		}
+		for (auto& field : data_object.meta_data) {
+			out.key(*field.first);
+			out.string_value(*field.second);
+		}
 	}
 	else {
-		progress_step = ceil(data_objects->size() / 100.0);
-	}
-	// write data objects
-	// open dataObjects tag
-	json_chunk += L"\"dataObjects\":[";
-	wcout << data_objects->size() << L" data objects" << endl;
-	while(!data_objects->empty()) {
-		map<wstring, map<wstring, wstring>> data_objects_element = data_objects->back();
-		data_objects->pop_back();
-		// open item tag {
-		json_chunk += L"\n\t{";
-		//json_chunk += "{";
-		for (map<wstring, map<wstring, wstring>>::value_type& data_object : data_objects_element) {
-			// open data_object tag (meta_data or payload)
-			json_chunk += L"\n\t\t";
-			json_chunk = json_chunk + L"\"" + data_object.first + L"\":\n\t\t\t{";
-			//json_chunk = json_chunk + "\"" + data_object.first + "\":{";
-			bool raw_data_link_opening_tag_created = false;
-			bool comment_opening_tag_created = false;
-
-			for (map<wstring, wstring>::value_type& field : data_object.second) {
-				// convert to integer wherever possible
-				// double second;
-				// wstring str_second;
-				// wistringstream iss(field.second);
-				// iss >> dec >> second;
-				json_chunk += L"\n\t\t\t\t";
-				
-
-				// check if png filename
-				if (field.first.find(L"png_filename___") != wstring::npos) {
-					// if raw_data_link opening tag was created, then it's not the first 
-					// filename. Remove the last character \n\t\t\t\t], characters
-					if (raw_data_link_opening_tag_created) {
-						json_chunk = json_chunk.substr(0, json_chunk.size() - 7);
-						json_chunk += L",";	// close previous one
-					}
-					// check if raw_data_link tag was already created, if not create
-					if (!raw_data_link_opening_tag_created) {
-						json_chunk += L"\"raw_data_link\":[";
-						raw_data_link_opening_tag_created = true;
-					}
-					// populate raw_data_link
-					json_chunk += L"\n\t\t\t\t\t{";
-					json_chunk += L"\n\t\t\t\t\t\t\"type\":\"PNG\",";
-					json_chunk += L"\n\t\t\t\t\t\t\"filename\":\"" + field.second + L"\"";
-					json_chunk += L"\n\t\t\t\t\t}";
-					// close raw_data_link tag
-					json_chunk += L"\n\t\t\t\t],";
-				}
-				else if (field.first.find(L"mat_filename___") != wstring::npos) {
-					// if raw_data_link opening tag was created, then it's not the first 
-					// filename. Remove the last character \n\t\t\t\t], characters
-					if (raw_data_link_opening_tag_created) {
-						json_chunk = json_chunk.substr(0, json_chunk.size() - 7);
-						json_chunk += L",";	// close previous one
-					}
-					// check if raw_data_link tag was already created, if not create
-					if (!raw_data_link_opening_tag_created) {
-						json_chunk += L"\"raw_data_link\":[";
-						raw_data_link_opening_tag_created = true;
-					}
-					// populate raw_data_link
-					json_chunk += L"\n\t\t\t\t\t{";
-					json_chunk += L"\n\t\t\t\t\t\t\"type\":\"MAT\",";
-					json_chunk += L"\n\t\t\t\t\t\t\"filename\":\"" + field.second + L"\"";
-					json_chunk += L"\n\t\t\t\t\t}";
-					// close raw_data_link tag
-					json_chunk += L"\n\t\t\t\t],";
-				}
-				else if (field.first.find(L"comment___") != wstring::npos) {
-					// if comment_opening_tag was created then it's not the first comment
-					if (comment_opening_tag_created) {
-						json_chunk = json_chunk.substr(0, json_chunk.size() - 7);
-						json_chunk += L",";	// close previous one
-					}
-					// check if comment tag was already created, if not create
-					if (!comment_opening_tag_created) {
-						json_chunk += L"\"comments\":[";
-						comment_opening_tag_created = true;
-					}
-					// add comment
-					json_chunk += L"\n\t\t\t\t\t\"" + field.second + L"\"";
-					// close comments tag
-					json_chunk += L"\n\t\t\t\t],";
-				}
-				else {
-					json_chunk = json_chunk + L"\"" + field.first + L"\":\"" + field.second + L"\",";
-				}
-				
-				// Writing everything as wstring to save precision for big number conversion to and from scientific version
-				// e.g. test_number = 12345678 as number becomes 1.23e6, which converts back to number as 1230000
-				/*
-				if (iss.fail() || field.first == "ts_data_created" || field.first == "dut_id" || field.first == "package" || field.first.find("cond_") != wstring::npos || 
-					field.first == "rddf_tc_id") {
-					// write inner object fields of meta or payload
-					json_chunk = json_chunk + "\"" + field.first + "\":\"" + field.second + "\",";
-				}
-				else {
-					if (second != 0) {
-						// 0 value is converted as empty
-						ostringstream strs;
-						strs << second;
-						str_second = strs.str();
-						str_second = this->strrep(str_second, ',', '.');
-					}
-					else {
-						// hardcode 0 wstring to avoid empty value
-						str_second = "0";
-					}
-					json_chunk = json_chunk + "\"" + field.first + "\":" + str_second + ",";
-				}
-				*/
-
+		for (auto& field : data_object.meta_data) {
+			out.key(*field.first);
+			out.string_value(*field.second);
+		}
+		out.key(L"test_number");
+		out.string_value(data_object.test_number);
+		out.key(L"parameter_name");
+		out.string_value(*data_object.test_name);
+		out.key(L"data_object_type");
+		out.string_value(L"limit");
+	}
+	out.end_object();
+
+	out.key(L"payload");
+	out.begin_object();
+	if (data_object.type == DataObject::VALUE) {
+		out.key(*data_object.test_name);
+		out.string_value(data_object.value);
+		// png/mat filenames
+		if (!data_object.raw_data_link.empty()) {
+			out.key(L"raw_data_link");
+			out.begin_array();
+			for (auto& raw_data_link : data_object.raw_data_link) {
+				out.begin_object();
+				out.key(L"type");
+				out.string_value(*raw_data_link.first);
+				out.key(L"filename");
+				out.string_value(*raw_data_link.second);
+				out.end_object();
 			}
-			// remove last ,
-			json_chunk = json_chunk.substr(0, json_chunk.size() - 1);
-			// close data_object tag }
-			json_chunk += L"\n\t\t\t},";
-			// json_chunk += "},";
+			out.end_array();
 		}
-		// remove last ,
-		json_chunk = json_chunk.substr(0, json_chunk.size() - 1);
-		// close item tag
-		json_chunk += L"\n\t},";
-		// json_chunk += "},";
-
-		// write to file every 100 steps to prevent dealing with huge strings
-		if (++c % 100 == 0) {
-			out << json_chunk;
-			json_chunk = L"";
+		if (!data_object.comments.empty()) {
+			out.key(L"comments");
+			out.begin_array();
+			for (auto& comment : data_object.comments) {
+				out.string_value(*comment);
+			}
+			out.end_array();
 		}
-		// update progress bar every {progress_steps}
-		if (c % progress_step == 0) {
-			wcout << '\r' << this->progress_bar(c, initial_size, progress_step);
+	}
+	else {
+		if (!data_object.scale.empty()) {
+			out.key(L"scale");
+			out.string_value(data_object.scale);
 		}
+		out.key(L"unit");
+		out.string_value(data_object.unit);
+		out.key(L"lower_limit");
+		out.string_value(data_object.lower_limit);
+		out.key(L"upper_limit");
+		out.string_value(data_object.upper_limit);
 	}
-	// update progress bar for final chunk
-	wcout << '\r' << this->progress_bar(c, initial_size, progress_step);
+	out.end_object();
 
+	// close item tag
+	out.end_object();
+}
+
+bool DataReader::end_json(JsonWriter& out, wstring recipe_payload, wstring json_path) {
 	// putting recipe
-	json_chunk += L"\n\t{";
-	json_chunk += L"\n\t\t\"metaData\":\n\t\t\t{\n\t\t\t\t\"data_object_type\":\"recipe\"\n\t\t\t},";
-	json_chunk += L"\n\t\t\"payload\":\n\t\t\t{\n\t\t\t\t\"recipe\":";
-	json_chunk += L"\"" + recipe_payload + L"\"\n\t\t\t}";
-	json_chunk += L"\n\t}";
+	out.begin_object();
+	out.key(L"metaData");
+	out.begin_object();
+	out.key(L"data_object_type");
+	out.string_value(L"recipe");
+	out.end_object();
+	out.key(L"payload");
+	out.begin_object();
+	out.key(L"recipe");
+	out.string_value(recipe_payload);
+	out.end_object();
+	out.end_object();
 
 	// close dataObjects tag
-	json_chunk += L"\n]";
+	out.end_array();
 
 	// close json }
-	json_chunk += L"\n}";
-	// wcout << json << endl;
-	// write last chunk
-	out << json_chunk;
+	out.end_object();
 
-	out.close();
-	wcout << endl << endl << L"JSON is saved in " << endl << json_path << endl << endl;
+	if (!out.close()) {
+		*this->log_stream << endl << L"Couldn't write JSON file: " << json_path << endl;
+		return false;
+	}
+	*this->log_stream << endl << endl << L"JSON is saved in " << endl << json_path << endl << endl;
 
 	return true;
 }
 
 vector<wstring> DataReader::strsplit(wstring line, wstring delimiters, bool collapse_delimiters) {
-	wstring temp;				// store temporarily built tokens
-	vector <wstring> tokens;		// final vector of tokens
-								// iteratre over each character in line
-	for (auto i = 0; i < line.size(); i++) {
-		// if current char is not in delimiters, save it to temp
-		if (delimiters.find(line[i]) == wstring::npos) {
-			temp += line[i];
-		}
-		// if current char is delimiting char
-		else {
-			// if temp is not empty and collapse_delimiters is chosen
-			// save current token
-			if (temp != L"" && collapse_delimiters) {
-				tokens.push_back(temp);
-			}
-			// if collapse_delimiters is false, add empty token
-			if (!collapse_delimiters) {
-				tokens.push_back(temp);
-			}
-			temp = L"";
-		}
-	}
-	// add remaining any non-empty token
-	if (temp != L"") {
-		tokens.push_back(temp);
-	}
+	// find tokens as views, copy them once at the end
+	vector<wstring_view> token_views;
+	Tokenizer::split(line, delimiters, collapse_delimiters, token_views);
+	vector<wstring> tokens;
+	Tokenizer::assign(token_views, tokens);
 
 	return tokens;
 }
 
-map <wstring, wstring> DataReader::construct_common_meta_data(wstring basic_type, wstring product_design_step, wstring product_sales_code, wstring username, wstring email) {
-	map <wstring, wstring> common_meta_data;
+wstring DataReader::get_ts_data_created() {
 	// construct ts_data_created
 	time_t theTime = time(NULL);
 	struct tm *aTime = localtime(&theTime);
@@ -383,8 +374,14 @@ map <wstring, wstring> DataReader::construct_common_meta_data(wstring basic_type
 		month_one_digit = true;
 	if (day < 10)
 		day__one_digit = true;
-	wstring ts_data_created = to_wstring(year) + ( (month_one_digit) ? to_wstring(0): + L"" ) + to_wstring(month) + ( (day__one_digit) ? to_wstring(0) : + L"") + to_wstring(day);
 	//wstring ts_data_created = to_wstring(year) + to_wstring(month) + to_wstring(day);
+	return to_wstring(year) + ( (month_one_digit) ? to_wstring(0): + L"" ) + to_wstring(month) + ( (day__one_digit) ? to_wstring(0) : + L"") + to_wstring(day);
+}
+
+map <wstring, wstring> DataReader::construct_common_meta_data(wstring basic_type, wstring product_design_step, wstring product_sales_code, wstring username, wstring email) {
+	map <wstring, wstring> common_meta_data;
+	// construct ts_data_created
+	wstring ts_data_created = this->get_ts_data_created();
 	// construct common meta data
 	common_meta_data[L"basic_type"] = basic_type;
 	common_meta_data[L"product_design_step"] = product_design_step;
@@ -403,23 +400,22 @@ map <wstring, wstring> DataReader::construct_common_meta_data(wstring basic_type
 	return common_meta_data;
 }
 
-map <wstring, wstring> DataReader::construct_limit_meta_data(map<wstring, wstring> common_meta_data, wstring req_id, wstring description, wstring typical, wstring test_number, wstring key_name) {
-	map <wstring, wstring> limit_meta_data;
-	// copy common meta_data into limit_meta_data, skip user_name
-	for (map<wstring, wstring>::value_type& com_meta : common_meta_data) {
+void DataReader::construct_limit_meta_data(DataObject& limit_data_object, const map<wstring, wstring>& common_meta_data, const wstring& req_id, 
+	const wstring& description, const wstring& typical, const string& test_number, const wstring& key_name) {
+	limit_data_object.type = DataObject::LIMIT;
+	// copy common meta_data into limit meta data, skip user_name
+	for (const map<wstring, wstring>::value_type& com_meta : common_meta_data) {
 		if (com_meta.first.compare(L"user_name") != 0) {
-			limit_meta_data[com_meta.first] = com_meta.second;
+			limit_data_object.meta_data.push_back(make_pair(this->string_pool->intern(com_meta.first), this->string_pool->intern(com_meta.second)));
 		}
 	}
-	limit_meta_data[L"reqID"] = req_id;
-	limit_meta_data[L"description"] = description;
-	limit_meta_data[L"typical"] = typical;
-	limit_meta_data[L"test_number"] = test_number;
-	limit_meta_data[L"p_number"] = L"";
-	limit_meta_data[L"parameter_name"] = key_name;
-	limit_meta_data[L"data_object_type"] = L"limit";
-	limit_meta_data[L"limit_type"] = L"spec";
-	return limit_meta_data;
+	limit_data_object.meta_data.push_back(make_pair(this->string_pool->intern(L"reqID"), this->string_pool->intern(req_id)));
+	limit_data_object.meta_data.push_back(make_pair(this->string_pool->intern(L"description"), this->string_pool->intern(description)));
+	limit_data_object.meta_data.push_back(make_pair(this->string_pool->intern(L"typical"), this->string_pool->intern(typical)));
+	limit_data_object.meta_data.push_back(make_pair(this->string_pool->intern(L"p_number"), StringPool::empty()));
+	limit_data_object.meta_data.push_back(make_pair(this->string_pool->intern(L"limit_type"), this->string_pool->intern(L"spec")));
+	limit_data_object.test_number = test_number;
+	limit_data_object.test_name = this->string_pool->intern(key_name);
 }
 
 wstring DataReader::construct_recipe(wstring report_template, wstring report_name, wstring project_name) {
@@ -446,16 +442,7 @@ wstring DataReader::construct_recipe(wstring report_template, wstring report_nam
 }
 
 wstring DataReader::scale_value(int scale, wstring value) {
-	wistringstream to_double2(value);
-	double current_value2;
-	to_double2 >> current_value2;
-	current_value2 = current_value2 * pow(10, -scale);
-	// convert back to wstring
-	wostringstream scaled_value;
-	scaled_value << current_value2;
-	wstring str_val = scaled_value.str();
-	str_val = this->strremove(str_val, ',');
-	return str_val;
+	return NumericScaler::scale(scale, value);
 }
 
 wstring DataReader::generate_limit_from_test_value(wstring value, bool is_upper_limit) {
@@ -487,22 +474,25 @@ wstring DataReader::generate_limit_from_test_value(wstring value, bool is_upper_
 
 
 wstring DataReader::strrep(wstring line, char from, char to) {
-	for (auto i = 0; i < line.size(); i++) {
-		if (char(line[i]) == char(from)) {
-			line[i] = to;
-		}
-	}
+	this->strrep_in_place(line, from, to);
 	return line;
 }
 
 wstring DataReader::strremove(wstring line, char rem) {
-	wstring new_line{};
+	this->strremove_in_place(line, rem);
+	return line;
+}
+
+void DataReader::strrep_in_place(wstring& line, char from, char to) {
 	for (auto i = 0; i < line.size(); i++) {
-		if (line[i] != rem) {
-			new_line += line[i];
+		if (char(line[i]) == char(from)) {
+			line[i] = to;
 		}
 	}
-	return new_line;
+}
+
+void DataReader::strremove_in_place(wstring& line, char rem) {
+	line.erase(remove_if(line.begin(), line.end(), [rem](wchar_t c) { return c == rem; }), line.end());
 }
 
 wstring DataReader::strtrim(wstring line) {
@@ -561,11 +551,8 @@ tuple<int, wstring> DataReader::get_unit_scale(const wstring& raw_unit) {
 	}
 	else if (raw_unit[0] == ']' || raw_unit[0] == '[') {
 		// invalid unit scale occured
-		wcout << L"INVALID UNIT OCCURED IN LIMITS (testlimits.txt): " << unit << endl;
-		system("PAUSE");
-		exit(1);
-		// mark as invalid raw_unit occured
-		return make_tuple(42, raw_unit);
+		*this->log_stream << L"INVALID UNIT OCCURED IN LIMITS (testlimits.txt): " << raw_unit << endl;
+		throw runtime_error("invalid unit " + LineReader::encode(raw_unit));
 	}
 	else {
 		scale = 0;
@@ -596,15 +583,11 @@ wstring DataReader::progress_bar(int curr, int total, int step) {
 }
 
 wstring DataReader::validate_param_name(wstring raw_param_name) {
-	wstring param_name = raw_param_name;
+	wstring param_name = move(raw_param_name);
 	// replace all special characters with _ to avoid Tembo crash
-	param_name = this->strrep(param_name, '-', '_');
-	param_name = this->strrep(param_name, '(', '_');
-	param_name = this->strrep(param_name, ')', '_');
-	param_name = this->strrep(param_name, '!', '_');
-	param_name = this->strrep(param_name, '#', '_');
-	param_name = this->strrep(param_name, ',', '_');
-	param_name = this->strrep(param_name, '.', '_');
+	for (char special : { '-', '(', ')', '!', '#', ',', '.' }) {
+		this->strrep_in_place(param_name, special, '_');
+	}
 	// if first char is _, remove it
 	if (param_name[0] == '_') {
 		param_name.erase(0, 1);
@@ -613,9 +596,37 @@ wstring DataReader::validate_param_name(wstring raw_param_name) {
 }
 
 wstring DataReader::convert_to_lower(wstring data) {
+	this->convert_to_lower_in_place(data);
+	return data;
+}
+
+void DataReader::convert_to_lower_in_place(wstring& data) {
 	transform(data.begin(), data.end(), data.begin(),
 		[](unsigned char c) { return tolower(c); });
-	return data;
+}
+
+void DataReader::set_log_stream(wostream* stream) {
+	this->log_stream = stream;
+}
+
+void DataReader::set_string_pool(StringPool* pool) {
+	this->string_pool = pool;
+}
+
+void DataReader::set_conversion_cache(ConversionCache* cache) {
+	this->conversion_cache = cache;
+}
+
+void DataReader::set_tracer(Tracer* tracer) {
+	this->tracer = tracer;
+}
+
+void DataReader::set_thread_pool(ThreadPool* thread_pool) {
+	this->thread_pool = thread_pool;
+}
+
+void DataReader::set_compact_json(bool compact) {
+	this->compact_json = compact;
 }
 
 wstring DataReader::get_excel_col_name(int col) {
@@ -10,6 +10,15 @@
 #include <algorithm>
 #include <tuple>
 #include <sstream>
+#include <stdexcept>
+#include "JsonWriter.h"
+#include "DataObject.h"
+#include "Tokenizer.h"
+#include "LineReader.h"
+#include "NumericScaler.h"
+#include "ConversionCache.h"
+#include "Tracer.h"
+#include "ThreadPool.h"
 
 #include <chrono>
 
@@ -29,25 +38,63 @@ class DataReader
 {
 
 protected:
+	// console output of the reader, can be redirected to keep output of parallel conversions together
+	wostream* log_stream = &wcout;
+	// interned keys and values of data objects, can be shared by readers whose data objects are written together
+	StringPool own_string_pool;
+	StringPool* string_pool = &own_string_pool;
+	// cache of per file parse results, nullptr if disabled
+	ConversionCache* conversion_cache = nullptr;
+	// spans of parsing and writing, nullptr if tracing is off
+	Tracer* tracer = nullptr;
+	// pool shared with other conversions (e.g. batch of folders), nullptr if the reader starts its own threads
+	ThreadPool* thread_pool = nullptr;
+	// JSON without line breaks and indentation
+	bool compact_json = false;
+
 	/*************************************************************************************************************************************************************************
 	* This function converts common_meta_data and data_objects structures into JSON in chunks
 	*
 	* Input:
 	*		header				map<wstring, wstring>									header struct <key, value> - redundant for now, only 1 item
 	*		common_meta_data	map<wstring, wstring>									<key, value> mapping for common_meta_data
-	*		data_objects		map<wstring, map<wstring, map<wstring, wstring>>>		all data_objects
+	*		data_objects		vector<DataObject>										all data_objects
 	*		json_path			wstring												where to store JSON file
 	*		recipe_payload		wstring												recipe for report generation
 	* Output:
 	*		res					bool												success or not
 	*
 	* This function converts all structures generated so far into JSON
-	* The processing is done in chunks of 500 objects to keep json wstring small (to avoid slow huge wstring manipulations)
-	* Wherever possible numeric values are written without "" marks
+	* JSON is streamed through JsonWriter as UTF-8, the writer flushes its buffer to file by byte size
+	* Data objects are moved out of data_objects while writing (data_objects is empty afterwards)
+	* Numeric common_meta_data values are written without "" marks, data object fields are always strings
+	* Fixed fields of DataObject are written directly, png/mat filenames into raw_data_link array, comments into comments array
 	* Recipe is written as last object
 	*
 	*************************************************************************************************************************************************************************/
-	bool json_writer(map<wstring, wstring>, map<wstring, wstring>, vector<map<wstring, map<wstring, wstring>>>*, wstring, wstring);
+	bool json_writer(map<wstring, wstring>, map<wstring, wstring>, vector<DataObject>*, wstring, wstring);
+
+
+	/*************************************************************************************************************************************************************************
+	* These functions write the JSON of json_writer piece by piece, for readers which don't keep all data objects in memory
+	*
+	* Input:
+	*		out					JsonWriter&												writer, opened by begin_json
+	*		header				map<wstring, wstring>									header struct
+	*		common_meta_data	map<wstring, wstring>									<key, value> mapping for common_meta_data
+	*		json_path			wstring												where to store JSON file
+	*		data_object			DataObject											data object to write
+	*		recipe_payload		wstring												recipe for report generation
+	* Output:
+	*		res					bool												begin_json: file could be opened, end_json: JSON was written
+	*
+	* begin_json writes header and commonMetaData and opens dataObjects, write_data_object is called once per data object,
+	* end_json writes the recipe and closes the file. JSON is exactly the one json_writer writes for the same data objects.
+	*
+	*************************************************************************************************************************************************************************/
+	bool begin_json(JsonWriter&, map<wstring, wstring>, map<wstring, wstring>, wstring);
+	void write_data_object(JsonWriter&, const DataObject&);
+	bool end_json(JsonWriter&, wstring, wstring);
 
 
 	/*************************************************************************************************************************************************************************
@@ -62,15 +109,57 @@ protected:
 	*
 	* This function splits given wstring (line) into tokens based on delimiters
 	* collapse_delimiter controls whether to remove all delimiters in sequence or add as empty token
+	* Tokens are found by Tokenizer::split, hot loops use it directly to avoid the copies
 	*
 	*************************************************************************************************************************************************************************/
 	vector<wstring> strsplit(wstring, wstring, bool collapse_delimiters = true);
 
 	
 	map <wstring, wstring> construct_common_meta_data(wstring, wstring, wstring, wstring, wstring);
-	map <wstring, wstring> construct_limit_meta_data(map<wstring, wstring>, wstring, wstring, wstring, wstring, wstring);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function returns the current date for ts_data_created of common meta data
+	*
+	* Output:
+	*		ts_data_created		wstring			date as yyyymmdd
+	*
+	*************************************************************************************************************************************************************************/
+	wstring get_ts_data_created();
+
+
+	/*************************************************************************************************************************************************************************
+	* This function sets meta data of a limit data object, payload (unit, limits, scale) is filled by caller
+	*
+	* Input:
+	*		limit_data_object	DataObject&					limit data object to update
+	*		common_meta_data	map<wstring, wstring>		common meta data, copied except user_name
+	*		req_id				wstring						reqID
+	*		description			wstring						description
+	*		typical				wstring						typical value
+	*		test_number			string						test number of the limited test (UTF-8)
+	*		key_name			wstring						parameter_name
+	*
+	*************************************************************************************************************************************************************************/
+	void construct_limit_meta_data(DataObject&, const map<wstring, wstring>&, const wstring&, const wstring&, const wstring&, const string&, const wstring&);
+
+
 	wstring construct_recipe(wstring, wstring, wstring);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function scales value according to the scale of its unit, see NumericScaler::scale
+	*
+	* Input:
+	*		scale		int			scale from get_unit_scale
+	*		value		wstring		value as read from file
+	* Output:
+	*		scaled		wstring		value * 10^-scale as shortest round trip text
+	*
+	*************************************************************************************************************************************************************************/
 	wstring scale_value(int, wstring);
+
+
 	wstring generate_limit_from_test_value(wstring, bool);
 
 
@@ -105,6 +194,22 @@ protected:
 	wstring strremove(wstring, char);
 
 
+	/*************************************************************************************************************************************************************************
+	* These functions replace or remove characters in place
+	*
+	* Input:
+	*		line	wstring&	line to update
+	*		from	char		to be replaced (strrep_in_place)
+	*		to		char		replaced by (strrep_in_place)
+	*		rem		char		to be removed (strremove_in_place)
+	*
+	* Same result as strrep and strremove, but the buffer of line is kept, e.g. for strings reused from row to row.
+	*
+	*************************************************************************************************************************************************************************/
+	void strrep_in_place(wstring&, char, char);
+	void strremove_in_place(wstring&, char);
+
+
 	/*************************************************************************************************************************************************************************
 	* This function trims ' ' from wstring
 	*
@@ -130,6 +235,8 @@ protected:
 	*
 	* This function determines scale from first char of raw_unit and removes
 	* fist character
+	* Units starting with [ or ] are invalid, the message is written to the log stream and runtime_error is thrown. Readers on
+	* worker threads don't stop the program, the conversion of the report fails instead.
 	*
 	*************************************************************************************************************************************************************************/
 	tuple<int, wstring>get_unit_scale(const wstring&);
@@ -206,6 +313,7 @@ public:
 	*
 	* Configs file is read line by line and split on ':' into key value pairs.
 	* Project name value is converted to all lower case (Tembo requirement)
+	* If the file can't be opened, the message is written to the log stream and runtime_error is thrown
 	*
 	*************************************************************************************************************************************************************************/
 	map <wstring, wstring> read_config_file(const wstring&);
@@ -224,6 +332,8 @@ public:
 	*
 	* Reads configs_struct and sets up necessary configurations. If there is no given value for specific configuration, hardcoded value will be used
 	* For CSV files (is_csv=true) ReportName is taken from configurations file, otherwise original file name is used
+	* Threads is the number of files converted in parallel, 0 (default) uses all cores
+	* StreamingSize is the size in MB from which EFF files are converted in two passes with little memory (default 512)
 	*
 	*************************************************************************************************************************************************************************/
 	map<wstring, wstring> setup_configurations(map<wstring, wstring>, bool);
@@ -240,6 +350,68 @@ public:
 	*
 	*************************************************************************************************************************************************************************/
 	wstring convert_to_lower(wstring);
+	// same as convert_to_lower, keeps the buffer of data
+	void convert_to_lower_in_place(wstring&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function redirects console output of the reader
+	*
+	* Input:
+	*		stream					wostream*		stream to write progress and warnings to (e.g. wostringstream of a worker thread)
+	*
+	*************************************************************************************************************************************************************************/
+	void set_log_stream(wostream*);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function sets the pool data objects of the reader intern their strings in
+	*
+	* Input:
+	*		pool					StringPool*		pool to use instead of the own one, must outlive the data objects (e.g. pool of the reader merging the results)
+	*
+	*************************************************************************************************************************************************************************/
+	void set_string_pool(StringPool*);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function sets the cache of per file parse results
+	*
+	* Input:
+	*		cache					ConversionCache*		cache to load unchanged files from and store parsed files to, nullptr (default) parses every file
+	*
+	*************************************************************************************************************************************************************************/
+	void set_conversion_cache(ConversionCache*);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function sets the tracer spans of the reader are added to
+	*
+	* Input:
+	*		tracer					Tracer*					tracer of the conversion, nullptr (default) records nothing
+	*
+	*************************************************************************************************************************************************************************/
+	void set_tracer(Tracer*);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function sets the thread pool files of the reader are converted on
+	*
+	* Input:
+	*		thread_pool				ThreadPool*				pool shared with other conversions, nullptr (default) starts a pool of 'Threads' workers per conversion
+	*
+	*************************************************************************************************************************************************************************/
+	void set_thread_pool(ThreadPool*);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function selects the layout of the written JSON
+	*
+	* Input:
+	*		compact					bool					true writes the JSON on one line ('JsonFormat: compact' or --compact), false (default) indented
+	*
+	*************************************************************************************************************************************************************************/
+	void set_compact_json(bool);
 
 };
 
@@ -9,6 +9,7 @@
 * author	Ali Ganbarov (IFAG ATV PSN D PD PRES)
 *************************************************************************************************************************************************************************/
 
+namespace filesys = std::experimental::filesystem;
 
 EFFReader::EFFReader() {
 }
@@ -21,12 +22,135 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 	map<wstring, wstring> header_struct;
 	header_struct[L"version"] = L"1.0.1";
 
+	// get report name from file name
+	wstring base_filename = eff_path.substr(eff_path.find_last_of(L"/\\") + 1);
+	wstring::size_type const p(base_filename.find_last_of('.'));
+	wstring file_without_extension = base_filename.substr(0, p);
+	wstring report_name = file_without_extension;
+
+	// files of at least StreamingSize MB are converted in two passes, without keeping the data objects in memory
+	uintmax_t streaming_size = 512;
+	try {
+		streaming_size = stoull(configs_struct[L"StreamingSize"]);
+	}
+	catch (exception &e) {
+		streaming_size = 512;
+	}
+	error_code ec;
+	uintmax_t file_size = filesys::file_size(eff_path, ec);
+	bool streaming = !ec && file_size >= (streaming_size << 20);
+	TraceSpan span(this->tracer, L"convert", L"eff_to_json");
+	span.arg(L"file", eff_path);
+	span.counter(L"file_bytes", ec ? 0 : file_size);
+	span.counter(L"streaming", streaming ? 1 : 0);
+
+	// parse file, unless it is unchanged since the last conversion
+	EFFFileResult result;
+	uint64_t cache_settings_hash = ConversionCache::hash_configs(configs_struct);
+	TraceSpan parse_span(this->tracer, L"parse", streaming ? L"parse_eff_file (find last occurrences)" : L"parse_eff_file");
+	parse_span.arg(L"file", eff_path);
+	bool cached = false;
+	filesys::file_time_type pass_file_time;
+	uintmax_t pass_file_size = 0;
+	if (streaming) {
+		// first pass only finds the last value of each key_cond_str
+		*this->log_stream << L"Large file (" << (file_size >> 20) << L" MB), converting in two passes" << endl;
+		// second pass has to read the same file again
+		pass_file_size = file_size;
+		pass_file_time = filesys::last_write_time(eff_path, ec);
+		this->parse_eff_file(eff_path, configs_struct, result, FIND_LAST_OCCURRENCES);
+		if (!result.opened) {
+			return false;
+		}
+	}
+	else if (!(cached = this->load_cached_result(eff_path, cache_settings_hash, result))) {
+		this->parse_eff_file(eff_path, configs_struct, result);
+		if (!result.opened) {
+			return false;
+		}
+		this->store_cached_result(eff_path, cache_settings_hash, result);
+	}
+	// every test row is listed once in repeated_conds
+	size_t num_rows = 0;
+	for (const vector<int>& repeated_cond : result.repeated_conds) {
+		num_rows += repeated_cond.size();
+	}
+	parse_span.counter(L"rows", num_rows);
+	parse_span.counter(L"data_objects", streaming ? result.last_occurrences.size() : result.data_objects.size());
+	parse_span.counter(L"cached", cached ? 1 : 0);
+	parse_span.end();
+	map <wstring, wstring>& common_meta_data = result.common_meta_data;
+	vector<DataObject>& data_objects = result.data_objects;
+	vector<vector<int>>& repeated_conds = result.repeated_conds;
+
+	if (result.cond_repetition) {
+		*this->log_stream << L"Repeated condition occured (saved only last occurence).. For more details please check 50_Report/" + report_name + L"_repeated_conditions.csv"
+			<< endl << endl << endl;
+		wofstream out(out_folder_path + L"\\" + report_name + L"_repeated_conditions.csv");
+		out << L"Lines\n";
+		for (vector<int>& repeated_cond : repeated_conds) {
+			if (repeated_cond.size() > 1) {
+				for (auto data : repeated_cond) {
+					out << data << L";";
+				}
+				out << L"\n";
+			}
+		}
+	}
+
+	// notify user about api_id_perl, if present
+	if (!configs_struct[L"api_id_perl"].empty()) {
+		*this->log_stream << endl << L"WARNING: api_id_perl is detected in Config_Tembo file. Test numbers are filled with dummy values!" << endl << endl;
+	}
+
+	// create recipe payload
+	wstring recipe_payload = this->construct_recipe(configs_struct[L"ReportTemplate"], report_name, configs_struct[L"Project"]);
+
+	wstring json_path = out_folder_path + L"\\" + report_name + L".json";
+	if (streaming) {
+		// second pass writes the values found by first pass and all limits directly
+		TraceSpan write_span(this->tracer, L"write", L"parse_eff_file (write last occurrences)");
+		write_span.arg(L"file", json_path);
+		if (this->file_changed(eff_path, pass_file_size, pass_file_time)) {
+			*this->log_stream << L"EFF file changed during first pass, convert it again once it is complete: " << eff_path << endl;
+			return false;
+		}
+		JsonWriter out;
+		if (!this->begin_json(out, header_struct, common_meta_data, json_path)) {
+			return false;
+		}
+		this->parse_eff_file(eff_path, configs_struct, result, WRITE_LAST_OCCURRENCES, &out);
+		*this->log_stream << result.written_objects << L" data objects" << endl;
+		bool res = this->end_json(out, recipe_payload, json_path);
+		// values of the second pass may not be the ones found by the first pass
+		if (res && this->file_changed(eff_path, pass_file_size, pass_file_time)) {
+			*this->log_stream << L"EFF file changed while writing JSON, convert it again once it is complete: " << eff_path << endl;
+			res = false;
+		}
+		write_span.counter(L"data_objects", result.written_objects);
+		write_span.counter(L"bytes", out.bytes_written());
+		return res;
+	}
+
+	bool res = this->json_writer(header_struct, common_meta_data, &data_objects, json_path, recipe_payload);
+	
+	return res;
+}
+
+void EFFReader::parse_eff_file(const wstring& eff_path, map<wstring, wstring> configs_struct, EFFFileResult& result, EFFPass pass, JsonWriter* out) {
 	// define common_meta_data
-	map <wstring, wstring> common_meta_data;
+	map <wstring, wstring>& common_meta_data = result.common_meta_data;
 	bool common_meta_was_created = false;
-	vector<map<wstring, map<wstring, wstring>>> data_objects;
-	// define internal_json as array of maps
-	map<wstring, map<wstring, map<wstring, wstring>>> internal_json;
+	vector<DataObject>& data_objects = result.data_objects;
+	// define internal_json as data objects in order of first occurrence, found by hash of key_cond_str
+	vector<DataObject> internal_json;
+	ConditionIndex internal_json_index;
+	// interned keys and values used for every data object
+	PooledString user_name_key = this->string_pool->intern(L"user_name");
+	PooledString rddf_tc_id_key = this->string_pool->intern(L"rddf_tc_id");
+	PooledString testunit_name_key = this->string_pool->intern(L"testunit_name");
+	PooledString testunit_version_key = this->string_pool->intern(L"testunit_version");
+	PooledString dummy_value = this->string_pool->intern(L"dummy");
 	// define unique params to keep track of already appeared params
 	// used to control adding limit only once for each param
 	map <wstring, int> unique_params;
@@ -38,8 +162,13 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 	wstring product_design_step = L"";
 	wstring package = L"";
 	wstring dut_id = L"";
+	// username only changes with the <<EFF:1.00>> line, it is interned once for all rows after it
+	PooledString user_name_value = StringPool::empty();
 	vector <wstring> conds;
 	vector <wstring> params;
+	// scale of each column unit, looked up on first use
+	const int unknown_scale = INT_MIN;
+	vector <int> unit_scales;
 	vector <wstring> units;
 	vector <wstring> usl;
 	vector <wstring> lsl;
@@ -48,35 +177,42 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 	// keep count of lines in file
 	int line_count = 0;
 	// define structure to keep repeated condition data for output
-	map<wstring, map<wstring, vector<int>>> repeated_conds;
-	bool cond_repetition = false;
+	vector<vector<int>>& repeated_conds = result.repeated_conds;
+	ConditionIndex repeated_cond_index;
+	bool& cond_repetition = result.cond_repetition;
 	int test_col_ind{};
 
-	// get report name from file name
-	wstring base_filename = eff_path.substr(eff_path.find_last_of(L"/\\") + 1);
-	wstring::size_type const p(base_filename.find_last_of('.'));
-	wstring file_without_extension = base_filename.substr(0, p);
-	wstring report_name = file_without_extension;
-
-	// start reading file
-	wifstream inf(eff_path);
-	if (!inf) {
-		wcout << L"Couldn't read eff file: " << eff_path << endl;
-		return false;
+	// start reading file, only a complete parse is cached
+	if (pass == PARSE_ALL) {
+		result.input_state = ConversionCache::file_state(eff_path);
 	}
-	locale loc("");
-	inf.imbue(loc);
-	while (inf) {
-		wstring strInp;
-		// read line
-		getline(inf, strInp);
+	LineReader inf;
+	if (!inf.open(eff_path, pass == PARSE_ALL ? &result.input_state.content : nullptr)) {
+		*this->log_stream << L"Couldn't read eff file: " << eff_path << endl;
+		return;
+	}
+	result.opened = true;
+	string_view raw_line;
+	wstring strInp;
+	// tokens of current line, views into strInp
+	vector<wstring_view> line_data;
+	// temporaries of test rows, reused from row to row
+	EFFRowScratch row;
+	while (inf.next_line(raw_line)) {
 		line_count++;
+		// markers are ASCII, so lines without any of them are skipped on raw bytes without decoding
+		if (raw_line.find("05_Die") == string_view::npos && raw_line.find("<<EFF:1.00>>") == string_view::npos &&
+			raw_line.find("<+EFF:1.00>") == string_view::npos && raw_line.find("<+PName>") == string_view::npos &&
+			raw_line.find("<Unit>") == string_view::npos && raw_line.find("<USL>") == string_view::npos && raw_line.find("<LSL>") == string_view::npos) {
+			continue;
+		}
+		LineReader::decode(raw_line, strInp);
 		// remove " from line to avoid JSON crash
-		strInp = this->strremove(strInp, '"');
+		this->strremove_in_place(strInp, '"');
 		// remove ' from line to avoid Tembo crash
-		strInp = this->strremove(strInp, '\'');
+		this->strremove_in_place(strInp, '\'');
 		// split line on ;
-		vector <wstring> line_data = this->strsplit(strInp, L";", false);
+		Tokenizer::split(strInp, L";", false, line_data);
 		// get username
 		if (strInp.find(L"<<EFF:1.00>>") != wstring::npos) {
 			// if username is not in configs
@@ -85,7 +221,7 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 				for (auto i = 0; i < line_data.size(); i++) {
 					if (line_data[i].find(L"Ref") != wstring::npos) {
 						vector <wstring> key_val;
-						key_val = this->strsplit(line_data[i], L"=");
+						key_val = this->strsplit(wstring(line_data[i]), L"=");
 						username = key_val[1];
 					}
 				}
@@ -93,10 +229,11 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 			else {
 				username = configs_struct[L"Username"];
 			}
+			user_name_value = this->string_pool->intern(username);
 		}
 		// get condition names
 		else if (strInp.find(L"<+EFF:1.00>") != wstring::npos) {
-			conds = line_data;
+			Tokenizer::assign(line_data, conds);
 			// get the col index of where test data starts
 			for (auto i = 0; i < conds.size(); i++) {
 				// convert to numeric wherever possible
@@ -113,33 +250,36 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 		}
 		// get param names
 		else if (strInp.find(L"<+PName>") != wstring::npos) {
-			params = line_data;
+			Tokenizer::assign(line_data, params);
 		}
 		// get units
 		else if (strInp.find(L"<Unit>") != wstring::npos) {
-			units = line_data;
+			Tokenizer::assign(line_data, units);
+			unit_scales.assign(units.size(), unknown_scale);
 		}
 		// get upper limits
 		else if (strInp.find(L"<USL>") != wstring::npos) {
-			usl = line_data;
+			Tokenizer::assign(line_data, usl);
 		}
 		// get lower limits
 		else if (strInp.find(L"<LSL>") != wstring::npos) {
-			lsl = line_data;
+			Tokenizer::assign(line_data, lsl);
 		}
 		// get test data
 		else if (strInp.find(L"05_Die") != wstring::npos) {
-			// row containing test values
-			test_data = line_data;
-			// init meta data struct to construct meta_data
-			map<wstring, wstring> meta_data;
-			// wstring containing combination of conditions
-			wstring cond_str = L"";
-			wstring key_cond_str = L"";
+			// row containing test values, strings of previous row are reused
+			Tokenizer::assign(line_data, test_data);
+			// init data object holding the conditions of current row, copied into each test value
+			RowMetaData& meta_data = row.meta_data;
+			meta_data.clear();
+			// meta_data as it is given to data objects, copied once with the first value of the row
+			shared_ptr<const RowMetaData> row_meta_data;
+			// hash of combination of conditions
+			ConditionHash cond_str;
 			// iterate through each piece of line_data for meta data, start from 1 
 			// (skip 05_Die) till beginning of actual test values
 			for (int col = 1; col < test_col_ind; col++) {
-				test_data[col] = this->strremove(test_data[col], ',');
+				this->strremove_in_place(test_data[col], ',');
 				// meta names are in conds
 				if (!conds[col].compare(L"design")) {
 					// split on _
@@ -181,116 +321,146 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 						test_data[col] = L"0";
 					}
 					// combine conditions
-					cond_str = cond_str + L"_" + test_data[col];
+					cond_str.add(test_data[col]);
 					// get value from current cell of the table
-					meta_data[key_name] = test_data[col];
+					if (pass != FIND_LAST_OCCURRENCES) {
+						meta_data.set_cond(this->string_pool->intern(key_name), this->string_pool->intern(test_data[col]));
+					}
 				}
 
 			}
 			//cond_str = cond_str + username + L"_" + basic_type + L"_" + product_sales_code + L"_" + product_design_step + L"_" +
 			//	package + L"_" + dut_id;
-			cond_str = cond_str + username;
-			repeated_conds[cond_str][eff_path].push_back(line_count);
+			cond_str.add(username);
+			if (pass != WRITE_LAST_OCCURRENCES) {
+				size_t repeated_cond = repeated_cond_index.insert(cond_str, repeated_conds.size());
+				if (repeated_cond == repeated_conds.size()) {
+					repeated_conds.emplace_back();
+				}
+				repeated_conds[repeated_cond].push_back(line_count);
+			}
 			if (!common_meta_was_created && basic_type != L"" && product_sales_code != L"" && product_design_step != L"") {
 				common_meta_data = this->construct_common_meta_data(basic_type, product_design_step, product_sales_code, username, configs_struct[L"Email"]);
 				common_meta_was_created = true;
 			}
+			// add meta fields which are the same for the whole row
+			meta_data.dut_id = this->string_pool->intern(dut_id);
+			// meta_data.set_meta(this->string_pool->intern(L"package"), this->string_pool->intern(package));
+			meta_data.set_meta(user_name_key, user_name_value);
 			// Once meta is ready, read the rest of row for test objects
 			for (auto col = test_col_ind; col < test_data.size(); col++) {
 				// skip if empty
 				if (test_data[col].empty()) {
 					continue;
 				}
-				// init structre to keep payload
-				map <wstring, wstring> payload;
-				// construct key_name from variables row, e.g. ibat_stb
-				wstring key_name = params[col];
-				// validate parameter name
-				key_name = this->validate_param_name(key_name);
+				// construct key_name from variables row, e.g. ibat_stb, and validate it
+				wstring key_name = this->validate_param_name(params[col]);
 				if (key_name.empty()) {
 					continue;
 				}
 				// add out param name to keep param conds str separately
-				key_cond_str = key_name + cond_str;
+				ConditionHash key_cond_str = cond_str.with(key_name);
+				if (pass == FIND_LAST_OCCURRENCES) {
+					// only remember where the last value of key_cond_str is, it overwrites all earlier ones
+					size_t occurrence = result.last_occurrence_index.insert(key_cond_str, result.last_occurrences.size());
+					if (occurrence == result.last_occurrences.size()) {
+						result.last_occurrences.push_back(make_pair(line_count, (int)col));
+					}
+					else {
+						result.last_occurrences[occurrence] = make_pair(line_count, (int)col);
+						cond_repetition = true;
+					}
+					continue;
+				}
 				// scale according to unit
 				int scale{};
-				wstring unit{};
-				wstring scaled_value{};
-				// get the scale for the payload
-				tie(scale, unit) = this->get_unit_scale(units[col]);
-				payload[key_name] = this->scale_value(scale, test_data[col]);
+				wstring& unit = row.unit;
+				// get the scale for the payload, unit of each column is looked up only once
+				if (col < unit_scales.size()) {
+					if (unit_scales[col] == unknown_scale) {
+						tie(unit_scales[col], unit) = this->get_unit_scale(units[col]);
+					}
+					scale = unit_scales[col];
+				}
+				// create dataObject for current out value with conditions of current row, clearing keeps the buffers of the previous value
+				if (!row_meta_data) {
+					row_meta_data = make_shared<const RowMetaData>(meta_data);
+				}
+				DataObject& data_object = row.data_object;
+				data_object.clear();
+				data_object.row = row_meta_data;
+				NumericScaler::scale(scale, test_data[col], data_object.value);
 				// add other meta fields
-				meta_data[L"test_name"] = key_name;
-				meta_data[L"data_object_type"] = L"value";
-				meta_data[L"dut_id"] = dut_id;
-				// meta_data["package"] = package;
-				meta_data[L"user_name"] = username;
+				data_object.test_name = this->string_pool->intern(key_name);
 				// set test number depending on if it's api or actual test number
 				if (configs_struct[L"api_id_perl"].empty()) {
 					if (conds[col].empty()) {
 						// if empty, take column number
-						meta_data[L"test_number"] = to_wstring(col);
+						data_object.test_number = to_string(col);
 					}
 					else {
 						// take test number as it is
-						meta_data[L"test_number"] = conds[col];
+						LineReader::encode(conds[col], data_object.test_number);
 					}
 				}
 				else {
 					// if api key is present take test number as column number
-					meta_data[L"test_number"] = to_wstring(col);
+					data_object.test_number = to_string(col);
 					// construct rddf_tc_id
-					meta_data[L"rddf_tc_id"] = configs_struct[L"api_id_perl"] + L":" + L"GID-" + conds[col];
+					data_object.set_meta(rddf_tc_id_key, this->string_pool->intern(configs_struct[L"api_id_perl"] + L":" + L"GID-" + conds[col]));
 					// Fill in dummy values (Christian request)
-					meta_data[L"testunit_name"] = L"dummy";
-					meta_data[L"testunit_version"] = L"dummy";
+					data_object.set_meta(testunit_name_key, dummy_value);
+					data_object.set_meta(testunit_version_key, dummy_value);
 				}
-
-				// create dataObject for current out value with payload and meta_data
-				map <wstring, map<wstring, wstring>> data_object;
-				data_object[L"payload"] = payload;
-				data_object[L"metaData"] = meta_data;
-				// if key_cond_str is already in internal_json
-				// mark flag true to inform user
-				if (internal_json.find(key_cond_str) != internal_json.end()) {
-					// cout << "Repeated condition on line: " << line_count<< endl;
-					cond_repetition = true;
+				size_t object_index = 0;
+				if (pass == PARSE_ALL) {
+					// story current metaData and payload in internal_json
+					object_index = internal_json_index.insert(key_cond_str, internal_json.size());
+					if (object_index == internal_json.size()) {
+						internal_json.push_back(move(data_object));
+					}
+					else {
+						// if key_cond_str is already in internal_json
+						// mark flag true to inform user
+						cond_repetition = true;
+						internal_json[object_index] = move(data_object);
+					}
+				}
+				else {
+					// npos if the file changed since the first pass, key_cond_str wasn't there then
+					size_t occurrence = result.last_occurrence_index.find(key_cond_str);
+					if (occurrence != ConditionIndex::npos && result.last_occurrences[occurrence] == make_pair(line_count, (int)col)) {
+						// no later value overwrites this one, write it right away
+						this->write_data_object(*out, data_object);
+						result.written_objects++;
+					}
 				}
-
-				// story current metaData and payload in internal_json
-				internal_json[key_cond_str] = data_object;
 
 				// check if current parameter is not in unique_params,
 				// add a limit for it
 				if (unique_params.find(key_name) == unique_params.end()) {
-					// create a payload for current limit
-					map <wstring, wstring> limit_payload;
-					// create a meta_data for current limit
-					map <wstring, wstring> limit_meta_data;
-					// define limit_struct to store single limit structure
-					map<wstring, wstring> limit_struct;
-
+					// create a data object for current limit
+					DataObject limit_data_object;
 					// construct limit payload
 					// hardcode scale to 0, because tembo does auto conversion
 					// New: setting scale to 0 leads to the scaling issue in tembo report, leave it empty and tembo will do auto conversion 
-					//limit_payload[L"scale"] = L"0";
+					//limit_data_object.scale = L"0";
 					
 					// get scale and unit
 					tie(scale, unit) = this->get_unit_scale(units[col]);
-					limit_payload[L"unit"] = unit;
-					//limit_payload[L"scale"] = scale;
+					LineReader::encode(unit, limit_data_object.unit);
+					//limit_data_object.scale = scale;
 
 					// get lower limit
-					wstring lower_limit{};
 					if (lsl[col].empty()) {
 						// hardcode
 						// limit_payload["lower_limit"] = generate_limit_from_test_value(payload[key_name], false);
 						// back to empty limit
-						limit_payload[L"lower_limit"] = L"";
+						limit_data_object.lower_limit = "";
 					}
 					else {
 						// scale limit acc to unit
-						limit_payload[L"lower_limit"] = this->scale_value(scale, lsl[col]);
+						NumericScaler::scale(scale, lsl[col], limit_data_object.lower_limit);
 					}
 
 					// get upper limit
@@ -298,22 +468,33 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 						// hardcode
 						// limit_payload["upper_limit"] = generate_limit_from_test_value(payload[key_name], true);
 						// back to empty limit
-						limit_payload[L"upper_limit"] = L"";
+						limit_data_object.upper_limit = "";
 					}
 					else {
-						limit_payload[L"upper_limit"] = this->scale_value(scale, usl[col]);
+						NumericScaler::scale(scale, usl[col], limit_data_object.upper_limit);
 					}
 
 					// get limit meta data
-					limit_meta_data = this->construct_limit_meta_data(common_meta_data, L"", L"", L"", meta_data[L"test_number"], key_name);
-
-					// create a data object for current limit
-					map <wstring, map<wstring, wstring>> limit_data_object;
-					limit_data_object[L"payload"] = limit_payload;
-					limit_data_object[L"metaData"] = limit_meta_data;
+					const string& value_test_number = pass == PARSE_ALL ? internal_json[object_index].test_number : data_object.test_number;
+					this->construct_limit_meta_data(limit_data_object, common_meta_data, L"", L"", L"", value_test_number, key_name);
 
-					// add limit_data_object to internal_json
-					internal_json[L"limit_for_" + key_name] = limit_data_object;
+					if (pass == PARSE_ALL) {
+						// add limit_data_object to internal_json
+						ConditionHash limit_key;
+						limit_key.add(L"limit_for_");
+						limit_key.add(key_name);
+						size_t limit_index = internal_json_index.insert(limit_key, internal_json.size());
+						if (limit_index == internal_json.size()) {
+							internal_json.push_back(move(limit_data_object));
+						}
+						else {
+							internal_json[limit_index] = move(limit_data_object);
+						}
+					}
+					else {
+						this->write_data_object(*out, limit_data_object);
+						result.written_objects++;
+					}
 					// store unique out params to prevent readding limit again
 					unique_params[key_name] = 1;
 				}
@@ -323,38 +504,62 @@ bool EFFReader::eff_to_json(wstring eff_path, map<wstring, wstring> configs_stru
 
 	// since current csv is done, copy remaining internal json objects into
 	// data_objects, because new file will have different params
-	for (map <wstring, map<wstring, map<wstring, wstring>>>::value_type& data_object : internal_json) {
-		data_objects.push_back(data_object.second);
-		internal_json.erase(data_object.first);
+	for (DataObject& data_object : internal_json) {
+		data_objects.push_back(move(data_object));
 	}
+	internal_json.clear();
+}
 
-	if (cond_repetition) {
-		wcout << L"Repeated condition occured (saved only last occurence).. For more details please check 50_Report/" + report_name + L"_repeated_conditions.csv"
-			<< endl << endl << endl;
-		wofstream out(out_folder_path + L"\\" + report_name + L"_repeated_conditions.csv");
-		out << L"Lines\n";
-		for (map<wstring, map<wstring, vector<int>>>::value_type& repeated_cond_str : repeated_conds) {
-			for (map<wstring, vector<int>>::value_type& repeated_cond : repeated_cond_str.second) {
-				if (repeated_cond.second.size() > 1) {
-					//out << repeated_cond_str.first << ";";
-					for (auto data : repeated_cond.second) {
-						out << data << L";";
-					}
-					out << L"\n";
+bool EFFReader::file_changed(const wstring& path, uintmax_t file_size, filesys::file_time_type file_time) {
+	error_code size_ec, time_ec;
+	uintmax_t current_size = filesys::file_size(path, size_ec);
+	filesys::file_time_type current_time = filesys::last_write_time(path, time_ec);
+	return size_ec || time_ec || current_size != file_size || current_time != file_time;
+}
+
+bool EFFReader::load_cached_result(const wstring& eff_path, uint64_t settings_hash, EFFFileResult& result) {
+	string payload;
+	if (this->conversion_cache == nullptr || !this->conversion_cache->load(L"eff", eff_path, settings_hash, payload)) {
+		return false;
+	}
+	CacheReader in(payload, this->string_pool);
+	in.get(result.common_meta_data);
+	in.get(result.data_objects);
+	in.get(result.cond_repetition);
+	in.get(result.repeated_conds);
+	if (!in.good()) {
+		// broken entry, parse file again
+		result = EFFFileResult();
+		return false;
+	}
+	result.opened = true;
+
+	// common meta data (also copied into limits) is dated on conversion, not on parsing
+	auto ts_data_created = result.common_meta_data.find(L"ts_data_created");
+	if (ts_data_created != result.common_meta_data.end()) {
+		ts_data_created->second = this->get_ts_data_created();
+		PooledString ts_data_created_key = this->string_pool->intern(ts_data_created->first);
+		PooledString ts_data_created_value = this->string_pool->intern(ts_data_created->second);
+		for (DataObject& data_object : result.data_objects) {
+			for (auto& field : data_object.meta_data) {
+				if (field.first == ts_data_created_key) {
+					field.second = ts_data_created_value;
 				}
 			}
 		}
 	}
+	*this->log_stream << L"Using cached results for eff: " << eff_path << endl;
+	return true;
+}
 
-	// notify user about api_id_perl, if present
-	if (!configs_struct[L"api_id_perl"].empty()) {
-		wcout << endl << L"WARNING: api_id_perl is detected in Config_Tembo file. Test numbers are filled with dummy values!" << endl << endl;
+void EFFReader::store_cached_result(const wstring& eff_path, uint64_t settings_hash, const EFFFileResult& result) {
+	if (this->conversion_cache == nullptr || !result.opened) {
+		return;
 	}
-
-	// create recipe payload
-	wstring recipe_payload = this->construct_recipe(configs_struct[L"ReportTemplate"], report_name, configs_struct[L"Project"]);
-
-	bool res = this->json_writer(header_struct, common_meta_data, &data_objects, out_folder_path + L"\\" + report_name + L".json", recipe_payload);
-	
-	return res;
-}
\ No newline at end of file
+	CacheWriter out;
+	out.put(result.common_meta_data);
+	out.put(result.data_objects);
+	out.put(result.cond_repetition);
+	out.put(result.repeated_conds);
+	this->conversion_cache->store(L"eff", eff_path, settings_hash, result.input_state, out.get_data());
+}
@@ -11,7 +11,11 @@
 #include <tuple>
 #include <sstream>
 #include "DataReader.h"
+#include "LineReader.h"
+#include "ConditionHash.h"
 #include <chrono>
+#include <climits>
+#include <experimental/filesystem>
 
 /*************************************************************************************************************************************************************************
 * maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
@@ -31,6 +35,78 @@ class EFFReader : public DataReader
 private:
 	wstring file_path;
 
+	// parse_eff_file keeps all data objects (PARSE_ALL) or streams them in two passes
+	enum EFFPass { PARSE_ALL, FIND_LAST_OCCURRENCES, WRITE_LAST_OCCURRENCES };
+
+	// everything parse_eff_file produces for one eff file
+	struct EFFFileResult {
+		bool opened = false;
+		map<wstring, wstring> common_meta_data;
+		// value and limit objects in the order of the JSON
+		vector<DataObject> data_objects;
+		bool cond_repetition = false;
+		// lines per cond_str in order of first occurrence
+		vector<vector<int>> repeated_conds;
+		// line and column of last value of each key_cond_str (FIND_LAST_OCCURRENCES)
+		ConditionIndex last_occurrence_index;
+		vector<pair<int, int>> last_occurrences;
+		// data objects written to JSON (WRITE_LAST_OCCURRENCES)
+		size_t written_objects = 0;
+		// eff file as it was parsed, stored with the result in the conversion cache (PARSE_ALL)
+		CacheFileState input_state;
+	};
+
+	// temporaries of a 05_Die row in parse_eff_file, reused from row to row so their buffers are only allocated for the first rows.
+	// data_object is moved into internal_json (PARSE_ALL) or written and overwritten by the next value (WRITE_LAST_OCCURRENCES)
+	struct EFFRowScratch {
+		RowMetaData meta_data;
+		DataObject data_object;
+		wstring unit;
+	};
+
+
+	/*************************************************************************************************************************************************************************
+	* This function parses a single eff file into data objects
+	*
+	* Input:
+	*		eff_path			wstring						path to eff file
+	*		configs_struct		map<wstring, wstring>		structure containing configurations
+	*		pass				EFFPass						PARSE_ALL, FIND_LAST_OCCURRENCES or WRITE_LAST_OCCURRENCES
+	*		out					JsonWriter*					JSON opened by begin_json (WRITE_LAST_OCCURRENCES only)
+	* Output:
+	*		result				EFFFileResult				common meta data, data objects and repeated conditions of the file
+	*
+	* This is the parsing part of eff_to_json, see there for details.
+	* PARSE_ALL keeps all data objects in result.data_objects. For large files the two other passes are used instead:
+	* FIND_LAST_OCCURRENCES only stores the line and column of the last value of each key_cond_str (hashed), plus common meta data
+	* and repeated conditions. WRITE_LAST_OCCURRENCES reads the file again and writes limits and the values found by the first pass
+	* directly into out, so memory depends on the number of distinct key_cond_str and not on the file size.
+	* Data objects are written in file order, PARSE_ALL keeps them in order of first occurrence of key_cond_str.
+	*
+	*************************************************************************************************************************************************************************/
+	void parse_eff_file(const wstring&, map<wstring, wstring>, EFFFileResult&, EFFPass pass = PARSE_ALL, JsonWriter* out = nullptr);
+
+
+
+	/*************************************************************************************************************************************************************************
+	* These functions load and store the result of parse_eff_file in the conversion cache
+	*
+	* Input:
+	*		eff_path			wstring						path to eff file
+	*		settings_hash		uint64_t					hash of configurations used for parsing
+	*		result				EFFFileResult				(store) result of parsing eff_path
+	* Output:
+	*		result				EFFFileResult				(load) cached result, ts_data_created is set to the current date
+	*		res					bool						(load) whether eff_path was found unchanged in cache
+	*
+	* Nothing is loaded or stored if no cache was set (set_conversion_cache).
+	*
+	*************************************************************************************************************************************************************************/
+	bool load_cached_result(const wstring&, uint64_t, EFFFileResult&);
+	void store_cached_result(const wstring&, uint64_t, const EFFFileResult&);
+	// whether size or modification time of a file are not the ones given (or the file can't be read anymore)
+	bool file_changed(const wstring& path, uintmax_t file_size, experimental::filesystem::file_time_type file_time);
+
 public:
 	EFFReader();
 	~EFFReader();
@@ -47,14 +123,13 @@ public:
 	*		res				bool								whether JSON construction was successful or not
 	*
 	* Internal variables explanation
-	*	cond_str			wstring												combination of conditions for given test value
-	*   key_cond_str		wstring												parameter name + cond_str to keep conditions for each param separately to avoid condition repetition
+	*	cond_str			ConditionHash										combination of conditions (and username) for given test value
+	*   key_cond_str		ConditionHash										cond_str + parameter name to keep conditions for each param separately to avoid condition repetition
 	*	common_meta_data	map<wstring, wstring>									stores common_meta_data as <key, value>, e.g. <username, Ali Ganbarov>
 	*	unique_params		map <wstring, int>									mapping for each unique param and test number, e.g. <ibat_rom, 123>
-	*	meta_data			map <wstring, wstring>								stores meta_data of each data object as <key, value>, e.g. <cond_vio, 5>
-	*	payload				map <wstring, wstring>								stores payload of each data object as <key, value>, e.g. <ibat_rom, 1.2345>
-	*	internal_json		map <wstring, map<wstring, map<wstring, wstring>>>		stores data in format map<key_cond_str, map<type, map_of_type<key, value>>> where type = payload or meta_data
-	*	data_objects		vector<map<wstring, map<wstring, wstring>>>			final version of all data_objects, similar to internal_json
+	*	meta_data			RowMetaData											stores conditions of current row, e.g. <cond_VIO, 5>, shared by all data objects of the row
+	*	internal_json		vector<DataObject>									stores data object per key_cond_str (found by a ConditionIndex) in order of first occurrence
+	*	data_objects		vector<DataObject>									final version of all data_objects, similar to internal_json
 	*	test_col_ind		integer												stores the column number where the test data starts
 	*
 	* <<EFF:1.00>> lines are used to get username, basic_type, product_design_step and product_sales_code for meta and common_meta data
@@ -71,6 +146,10 @@ public:
 	*
 	* Test or limit values are scaled based on units
 	*
+	* If a conversion cache is set and the file didn't change since the last conversion with the same configurations, the parse result is
+	* taken from the cache and only the JSON is written again
+	* Files of at least StreamingSize MB (configs_struct) are read twice instead, see parse_eff_file. They are not cached.
+	*
 	*************************************************************************************************************************************************************************/
 	bool eff_to_json(wstring, map<wstring, wstring>, wstring);
 };
@@ -0,0 +1,125 @@
+#include "FolderWatcher.h"
+#include <windows.h>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+struct FolderWatcher::Watch {
+	wstring folder;
+	HANDLE directory = INVALID_HANDLE_VALUE;
+	OVERLAPPED overlapped;
+	// FILE_NOTIFY_INFORMATION entries are DWORD aligned
+	vector<DWORD> buffer;
+};
+
+FolderWatcher::FolderWatcher() {
+}
+
+FolderWatcher::~FolderWatcher() {
+	for (auto& watch : watches) {
+		CancelIo(watch->directory);
+		// wait until the pending read released the buffer
+		DWORD bytes = 0;
+		GetOverlappedResult(watch->directory, &watch->overlapped, &bytes, TRUE);
+		CloseHandle(watch->overlapped.hEvent);
+		CloseHandle(watch->directory);
+	}
+}
+
+bool FolderWatcher::watch(const wstring& folder) {
+	unique_ptr<Watch> watch(new Watch());
+	watch->folder = folder;
+	watch->directory = CreateFileW(folder.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL,
+		OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+	if (watch->directory == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	ZeroMemory(&watch->overlapped, sizeof(watch->overlapped));
+	watch->overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+	// 64 kB is the largest buffer ReadDirectoryChangesW accepts for network shares
+	watch->buffer.resize((64 * 1024) / sizeof(DWORD));
+	if (watch->overlapped.hEvent == NULL || !this->start_read(*watch)) {
+		if (watch->overlapped.hEvent != NULL) {
+			CloseHandle(watch->overlapped.hEvent);
+		}
+		CloseHandle(watch->directory);
+		return false;
+	}
+	watches.push_back(move(watch));
+	return true;
+}
+
+bool FolderWatcher::start_read(Watch& watch) {
+	ResetEvent(watch.overlapped.hEvent);
+	return ReadDirectoryChangesW(watch.directory, watch.buffer.data(), (DWORD)(watch.buffer.size() * sizeof(DWORD)), TRUE,
+		FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE,
+		NULL, &watch.overlapped, NULL) != 0;
+}
+
+bool FolderWatcher::wait(vector<Change>& changes, chrono::milliseconds timeout) {
+	changes.clear();
+	if (watches.empty()) {
+		return false;
+	}
+	vector<HANDLE> events;
+	for (auto& watch : watches) {
+		events.push_back(watch->overlapped.hEvent);
+	}
+	DWORD signaled = WaitForMultipleObjects((DWORD)events.size(), events.data(), FALSE, (DWORD)timeout.count());
+	if (signaled == WAIT_TIMEOUT || signaled == WAIT_FAILED) {
+		return false;
+	}
+
+	// collect all folders with finished reads, not only the first one
+	bool overflow = false;
+	for (auto& watch : watches) {
+		if (WaitForSingleObject(watch->overlapped.hEvent, 0) != WAIT_OBJECT_0) {
+			continue;
+		}
+		DWORD bytes = 0;
+		if (!GetOverlappedResult(watch->directory, &watch->overlapped, &bytes, FALSE) || bytes == 0) {
+			// buffer was too small for all changes since the last read
+			overflow = true;
+		}
+		else {
+			const char* entry = (const char*)watch->buffer.data();
+			while (true) {
+				const FILE_NOTIFY_INFORMATION* info = (const FILE_NOTIFY_INFORMATION*)entry;
+				Change change;
+				change.path = watch->folder + L"\\" + wstring(info->FileName, info->FileNameLength / sizeof(WCHAR));
+				switch (info->Action) {
+				case FILE_ACTION_ADDED:
+					change.action = ADDED;
+					break;
+				case FILE_ACTION_REMOVED:
+					change.action = REMOVED;
+					break;
+				case FILE_ACTION_RENAMED_OLD_NAME:
+					change.action = RENAMED_OLD_NAME;
+					break;
+				case FILE_ACTION_RENAMED_NEW_NAME:
+					change.action = RENAMED_NEW_NAME;
+					break;
+				default:
+					change.action = MODIFIED;
+					break;
+				}
+				changes.push_back(change);
+				if (info->NextEntryOffset == 0) {
+					break;
+				}
+				entry += info->NextEntryOffset;
+			}
+		}
+		if (!this->start_read(*watch)) {
+			overflow = true;
+		}
+	}
+	return overflow;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <chrono>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* Reports files created, changed, renamed or deleted below one or more folders
+*
+* Uses ReadDirectoryChangesW on the whole sub tree of every folder, so new files are seen without listing directories again.
+* A folder which is moved or copied into a watched folder is reported as one change of the folder itself, not of the files in it.
+* If Windows had to drop changes (more changes than fit into the buffer between two calls), wait returns overflow and the caller
+* has to scan the folders again.
+*
+*************************************************************************************************************************************************************************/
+class FolderWatcher
+{
+
+public:
+	// FILE_ACTION_* of Windows, a folder is MODIFIED whenever files in it change
+	enum Action { ADDED, REMOVED, MODIFIED, RENAMED_OLD_NAME, RENAMED_NEW_NAME };
+
+	struct Change {
+		wstring path;
+		Action action;
+	};
+
+private:
+	// one watched folder, Windows handles are kept out of this header
+	struct Watch;
+	vector<unique_ptr<Watch>> watches;
+
+	bool start_read(Watch&);
+
+public:
+	FolderWatcher();
+	~FolderWatcher();
+
+	FolderWatcher(const FolderWatcher&) = delete;
+	FolderWatcher& operator=(const FolderWatcher&) = delete;
+
+
+	/*************************************************************************************************************************************************************************
+	* This function starts watching a folder and all folders below it
+	*
+	* Input:
+	*		folder		wstring		folder to watch
+	* Output:
+	*		res			bool		whether folder could be opened
+	*
+	*************************************************************************************************************************************************************************/
+	bool watch(const wstring&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function waits for changes in any watched folder
+	*
+	* Input:
+	*		timeout		chrono::milliseconds		longest time to wait if nothing changes
+	* Output:
+	*		changes		vector<Change>				changes in the order Windows reported them, empty after timeout
+	*		overflow	bool						whether changes were dropped, changes is incomplete then
+	*
+	*************************************************************************************************************************************************************************/
+	bool wait(vector<Change>&, chrono::milliseconds);
+};
+
@@ -0,0 +1,220 @@
+#include "InputCatalog.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+namespace filesys = std::experimental::filesystem;
+
+// order of the typed lists inside the bucket arrays
+enum { CSV_BUCKET, EFF_BUCKET, PNG_BUCKET, MAT_BUCKET, CONFIG_BUCKET, LIMITS_BUCKET, NUM_BUCKETS };
+
+InputCatalog::InputCatalog() {
+}
+
+InputCatalog::~InputCatalog() {
+}
+
+void InputCatalog::classify(const wstring& file_path, vector<wstring>* buckets) {
+	filesys::path path(file_path);
+	wstring file_name = path.filename().wstring();
+	wstring extension = path.extension().wstring();
+	transform(file_name.begin(), file_name.end(), file_name.begin(), ::towlower);
+	transform(extension.begin(), extension.end(), extension.begin(), ::towlower);
+
+	if (file_name == L"config_tembo.txt") {
+		buckets[CONFIG_BUCKET].push_back(file_path);
+	}
+	else if (file_name == L"testlimits.txt") {
+		buckets[LIMITS_BUCKET].push_back(file_path);
+	}
+	else if (extension == L".csv") {
+		buckets[CSV_BUCKET].push_back(file_path);
+	}
+	else if (extension == L".eff") {
+		buckets[EFF_BUCKET].push_back(file_path);
+	}
+	else if (extension == L".png") {
+		buckets[PNG_BUCKET].push_back(file_path);
+	}
+	else if (extension == L".mat") {
+		buckets[MAT_BUCKET].push_back(file_path);
+	}
+}
+
+void InputCatalog::scan(const wstring& root, unsigned int num_workers) {
+	vector<wstring>* lists[NUM_BUCKETS] = { &csv_files, &eff_files, &png_files, &mat_files, &config_files, &limits_files };
+	for (auto list : lists) {
+		list->clear();
+	}
+
+	try {
+		// Check if given path exists and points to a directory
+		if (!filesys::exists(root) || !filesys::is_directory(root)) {
+			return;
+		}
+	}
+	catch (system_error &e) {
+		cerr << "Exception :: " << e.what();
+		return;
+	}
+
+	if (num_workers == 0) {
+		num_workers = max(1u, thread::hardware_concurrency());
+	}
+
+	// directories waiting to be listed and number of directories currently being listed
+	deque<filesys::path> pending_dirs;
+	int busy_workers = 0;
+	mutex catalog_mutex;
+	condition_variable catalog_cv;
+	pending_dirs.push_back(root);
+
+	auto worker = [&]() {
+		while (true) {
+			filesys::path dir;
+			{
+				unique_lock<mutex> lock(catalog_mutex);
+				// wait for work, stop once the queue is drained and nobody can add to it anymore
+				catalog_cv.wait(lock, [&]() { return !pending_dirs.empty() || busy_workers == 0; });
+				if (pending_dirs.empty()) {
+					return;
+				}
+				dir = pending_dirs.front();
+				pending_dirs.pop_front();
+				busy_workers++;
+			}
+
+			vector<filesys::path> sub_dirs;
+			vector<wstring> buckets[NUM_BUCKETS];
+			error_code ec;
+			filesys::directory_iterator iter(dir, ec);
+			filesys::directory_iterator end;
+			if (ec) {
+				cerr << "Error While Accessing : " << dir.string() << " :: " << ec.message() << '\n';
+			}
+			while (!ec && iter != end) {
+				try {
+					error_code status_ec;
+					filesys::file_status status = iter->symlink_status(status_ec);
+					if (filesys::is_directory(status)) {
+						sub_dirs.push_back(iter->path());
+					}
+					// linked directories are not followed, same as the recursive iterator
+					else if (!filesys::is_directory(iter->path(), status_ec)) {
+						this->classify(iter->path().wstring(), buckets);
+					}
+				}
+				catch (invalid_argument &e) {
+					// path couldn't be converted, skip entry
+				}
+				// Increment the iterator to point to next entry
+				iter.increment(ec);
+				if (ec) {
+					cerr << "Error While Accessing : " << dir.string() << " :: " << ec.message() << '\n';
+				}
+			}
+
+			{
+				lock_guard<mutex> lock(catalog_mutex);
+				for (auto& sub_dir : sub_dirs) {
+					pending_dirs.push_back(sub_dir);
+				}
+				for (int i = 0; i < NUM_BUCKETS; i++) {
+					lists[i]->insert(lists[i]->end(), buckets[i].begin(), buckets[i].end());
+				}
+				busy_workers--;
+			}
+			catalog_cv.notify_all();
+		}
+	};
+
+	vector<thread> workers;
+	for (unsigned int i = 0; i < num_workers; i++) {
+		workers.push_back(thread(worker));
+	}
+	for (auto& w : workers) {
+		w.join();
+	}
+
+	// make the order independent of thread scheduling
+	for (auto list : lists) {
+		sort(list->begin(), list->end(), path_less);
+	}
+}
+
+bool InputCatalog::path_less(const wstring& a, const wstring& b) {
+	size_t a_begin = 0;
+	size_t b_begin = 0;
+	while (true) {
+		size_t a_end = a.find(L'\\', a_begin);
+		size_t b_end = b.find(L'\\', b_begin);
+		// last part is the file name
+		bool a_is_file = a_end == wstring::npos;
+		bool b_is_file = b_end == wstring::npos;
+		if (a_is_file != b_is_file) {
+			return a_is_file;
+		}
+		if (a_is_file) {
+			a_end = a.size();
+			b_end = b.size();
+		}
+		// compare names of the current level without case
+		size_t i = a_begin;
+		size_t j = b_begin;
+		for (; i < a_end && j < b_end; i++, j++) {
+			wint_t a_char = towupper(a[i]);
+			wint_t b_char = towupper(b[j]);
+			if (a_char != b_char) {
+				return a_char < b_char;
+			}
+		}
+		if (i < a_end || j < b_end) {
+			return i == a_end;
+		}
+		if (a_is_file) {
+			break;
+		}
+		a_begin = a_end + 1;
+		b_begin = b_end + 1;
+	}
+	// same path in different case
+	return a < b;
+}
+
+bool InputCatalog::add_file(const wstring& file_path) {
+	vector<wstring>* lists[NUM_BUCKETS] = { &csv_files, &eff_files, &png_files, &mat_files, &config_files, &limits_files };
+	vector<wstring> buckets[NUM_BUCKETS];
+	this->classify(file_path, buckets);
+	for (int i = 0; i < NUM_BUCKETS; i++) {
+		if (buckets[i].empty()) {
+			continue;
+		}
+		auto pos = lower_bound(lists[i]->begin(), lists[i]->end(), file_path, path_less);
+		if (pos != lists[i]->end() && *pos == file_path) {
+			return false;
+		}
+		lists[i]->insert(pos, file_path);
+		return true;
+	}
+	return false;
+}
+
+bool InputCatalog::remove_path(const wstring& file_path) {
+	vector<wstring>* lists[NUM_BUCKETS] = { &csv_files, &eff_files, &png_files, &mat_files, &config_files, &limits_files };
+	wstring folder_prefix = file_path + L"\\";
+	bool removed = false;
+	for (auto list : lists) {
+		auto last = remove_if(list->begin(), list->end(), [&](const wstring& file) {
+			return file == file_path || file.compare(0, folder_prefix.size(), folder_prefix) == 0;
+		});
+		removed = removed || last != list->end();
+		list->erase(last, list->end());
+	}
+	return removed;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <string>
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <cwctype>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <experimental/filesystem>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+class InputCatalog
+{
+
+private:
+	vector<wstring> csv_files;
+	vector<wstring> eff_files;
+	vector<wstring> png_files;
+	vector<wstring> mat_files;
+	vector<wstring> config_files;
+	vector<wstring> limits_files;
+
+
+	/*************************************************************************************************************************************************************************
+	* This function sorts a single file into the typed lists
+	*
+	* Input:
+	*		file_path		wstring				absolute path of the file
+	*		buckets			vector<wstring>*	array of 6 lists (csv, eff, png, mat, config, limits) to add the file to
+	*
+	* Config_Tembo.txt and testlimits.txt are matched on the whole file name, all other inputs on the exact extension.
+	* Comparison is case insensitive, since Windows file names are.
+	*
+	*************************************************************************************************************************************************************************/
+	void classify(const wstring&, vector<wstring>*);
+
+public:
+	InputCatalog();
+	~InputCatalog();
+
+
+	/*************************************************************************************************************************************************************************
+	* This function walks the directory tree once and catalogs all input files
+	*
+	* Input:
+	*		root			wstring				directory to walk recursively
+	*		num_workers		unsigned int		number of parallel walkers, 0 = number of cores
+	*
+	* Directories are handed out to num_workers threads through a shared queue. Each worker lists one directory, queues its
+	* sub directories and sorts the files by type into local lists, which are merged into the catalog under lock.
+	* All lists are sorted at the end (path_less), so the result doesn't depend on thread scheduling.
+	* Previous scan results are dropped.
+	*
+	*************************************************************************************************************************************************************************/
+	void scan(const wstring&, unsigned int num_workers = 0);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function gives the order of all file lists
+	*
+	* Input:
+	*		a, b			wstring				absolute paths
+	* Output:
+	*		res				bool				whether a comes before b
+	*
+	* Paths are compared one folder at a time and case insensitive, like Explorer lists NTFS folders. Files of a folder come before
+	* everything in its sub folders, so the lists are in the depth first order of a walk through the tree. All files below a folder
+	* are next to each other, the first one is found with lower_bound of the folder path with a trailing '\'.
+	*
+	*************************************************************************************************************************************************************************/
+	static bool path_less(const wstring&, const wstring&);
+
+
+	/*************************************************************************************************************************************************************************
+	* These functions update the catalog for a single file, e.g. after a change reported by FolderWatcher
+	*
+	* Input:
+	*		file_path		wstring				absolute path of the file (remove_path: of a file or folder)
+	* Output:
+	*		res				bool				add_file: whether file is an input and wasn't in the catalog yet
+	*											remove_path: whether anything was removed
+	*
+	* Lists stay sorted. remove_path also removes all files below file_path, for folders which were deleted or renamed.
+	*
+	*************************************************************************************************************************************************************************/
+	bool add_file(const wstring&);
+	bool remove_path(const wstring&);
+
+	const vector<wstring>& get_csv_files() const { return csv_files; }
+	const vector<wstring>& get_eff_files() const { return eff_files; }
+	const vector<wstring>& get_png_files() const { return png_files; }
+	const vector<wstring>& get_mat_files() const { return mat_files; }
+	const vector<wstring>& get_config_files() const { return config_files; }
+	const vector<wstring>& get_limits_files() const { return limits_files; }
+};
+
@@ -0,0 +1,251 @@
+#include "JsonWriter.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+JsonWriter::JsonWriter(size_t flush_threshold) : flush_threshold(flush_threshold) {
+	// some room above the threshold, so a single value doesn't trigger reallocation
+	buffer.reserve(flush_threshold + 4096);
+}
+
+JsonWriter::~JsonWriter() {
+	if (out.is_open()) {
+		this->close();
+	}
+}
+
+bool JsonWriter::open(const wstring& json_path) {
+	out.open(json_path, ios::out | ios::binary | ios::trunc);
+	buffer.clear();
+	scopes.clear();
+	total_bytes = 0;
+	write_failed = !out.is_open();
+	after_key = false;
+	return !write_failed;
+}
+
+bool JsonWriter::close() {
+	if (!buffer.empty()) {
+		out.write(buffer.data(), buffer.size());
+		total_bytes += buffer.size();
+		buffer.clear();
+	}
+	out.close();
+	if (out.fail()) {
+		write_failed = true;
+	}
+	return !write_failed;
+}
+
+void JsonWriter::flush_if_needed() {
+	if (buffer.size() >= flush_threshold) {
+		out.write(buffer.data(), buffer.size());
+		if (!out) {
+			write_failed = true;
+		}
+		total_bytes += buffer.size();
+		buffer.clear();
+	}
+}
+
+void JsonWriter::indent(int level) {
+	buffer.append(level, '\t');
+}
+
+void JsonWriter::separator() {
+	Scope& scope = scopes.back();
+	if (!scope.is_empty) {
+		buffer += ',';
+	}
+	scope.is_empty = false;
+	if (!compact) {
+		buffer += '\n';
+		this->indent(scope.member_indent);
+	}
+}
+
+void JsonWriter::begin_scope(bool is_array) {
+	Scope scope;
+	scope.is_array = is_array;
+	scope.is_empty = true;
+	if (after_key) {
+		if (is_array) {
+			// array opens on the line of its key
+			scope.member_indent = key_indent + 1;
+			scope.close_indent = key_indent;
+		}
+		else {
+			// object goes to the next line, one level deeper than its key
+			if (!compact) {
+				buffer += '\n';
+				this->indent(key_indent + 1);
+			}
+			scope.member_indent = key_indent + 2;
+			scope.close_indent = key_indent + 1;
+		}
+		after_key = false;
+	}
+	else if (!scopes.empty()) {
+		// element of an array
+		this->separator();
+		scope.member_indent = scopes.back().member_indent + 1;
+		scope.close_indent = scopes.back().member_indent;
+	}
+	else {
+		// root, members are not indented
+		scope.member_indent = 0;
+		scope.close_indent = 0;
+	}
+	buffer += is_array ? '[' : '{';
+	scopes.push_back(scope);
+}
+
+void JsonWriter::end_scope() {
+	Scope scope = scopes.back();
+	scopes.pop_back();
+	if (!compact) {
+		buffer += '\n';
+		this->indent(scope.close_indent);
+	}
+	buffer += scope.is_array ? ']' : '}';
+	this->flush_if_needed();
+}
+
+void JsonWriter::begin_object() {
+	this->begin_scope(false);
+}
+
+void JsonWriter::end_object() {
+	this->end_scope();
+}
+
+void JsonWriter::begin_array() {
+	this->begin_scope(true);
+}
+
+void JsonWriter::end_array() {
+	this->end_scope();
+}
+
+void JsonWriter::key(const wstring& name) {
+	this->separator();
+	buffer += '"';
+	this->append_utf8(name, true);
+	buffer += "\":";
+	after_key = true;
+	key_indent = scopes.back().member_indent;
+}
+
+void JsonWriter::key(string_view name) {
+	this->separator();
+	buffer += '"';
+	this->append_escaped(name);
+	buffer += "\":";
+	after_key = true;
+	key_indent = scopes.back().member_indent;
+}
+
+void JsonWriter::string_value(const wstring& value) {
+	if (!after_key) {
+		this->separator();
+	}
+	after_key = false;
+	buffer += '"';
+	this->append_utf8(value, true);
+	buffer += '"';
+	this->flush_if_needed();
+}
+
+void JsonWriter::string_value(string_view value) {
+	if (!after_key) {
+		this->separator();
+	}
+	after_key = false;
+	buffer += '"';
+	this->append_escaped(value);
+	buffer += '"';
+	this->flush_if_needed();
+}
+
+void JsonWriter::raw_value(const wstring& value) {
+	if (!after_key) {
+		this->separator();
+	}
+	after_key = false;
+	this->append_utf8(value, false);
+	this->flush_if_needed();
+}
+
+void JsonWriter::append_utf8(const wstring& text, bool escape) {
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned long c = (unsigned long)text[i];
+		// combine UTF-16 surrogate pair (wchar_t is 16 bit on Windows)
+		if (c >= 0xD800 && c <= 0xDBFF && i + 1 < text.size()) {
+			unsigned long low = (unsigned long)text[i + 1];
+			if (low >= 0xDC00 && low <= 0xDFFF) {
+				c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+				i++;
+			}
+		}
+		if (c < 0x80) {
+			if (escape && (c == '"' || c == '\\')) {
+				buffer += '\\';
+				buffer += (char)c;
+			}
+			else if (escape && c < 0x20) {
+				const char* hex = "0123456789abcdef";
+				buffer += "\\u00";
+				buffer += hex[c >> 4];
+				buffer += hex[c & 0xF];
+			}
+			else {
+				buffer += (char)c;
+			}
+		}
+		else if (c < 0x800) {
+			buffer += (char)(0xC0 | (c >> 6));
+			buffer += (char)(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000) {
+			buffer += (char)(0xE0 | (c >> 12));
+			buffer += (char)(0x80 | ((c >> 6) & 0x3F));
+			buffer += (char)(0x80 | (c & 0x3F));
+		}
+		else {
+			buffer += (char)(0xF0 | (c >> 18));
+			buffer += (char)(0x80 | ((c >> 12) & 0x3F));
+			buffer += (char)(0x80 | ((c >> 6) & 0x3F));
+			buffer += (char)(0x80 | (c & 0x3F));
+		}
+	}
+}
+
+void JsonWriter::append_escaped(string_view text) {
+	size_t start = 0;
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned char c = (unsigned char)text[i];
+		if (c != '"' && c != '\\' && c >= 0x20) {
+			continue;
+		}
+		// copy everything up to the char to escape at once
+		buffer.append(text.data() + start, i - start);
+		start = i + 1;
+		if (c < 0x20) {
+			const char* hex = "0123456789abcdef";
+			buffer += "\\u00";
+			buffer += hex[c >> 4];
+			buffer += hex[c & 0xF];
+		}
+		else {
+			buffer += '\\';
+			buffer += (char)c;
+		}
+	}
+	buffer.append(text.data() + start, text.size() - start);
+}
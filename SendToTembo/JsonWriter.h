@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <vector>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+class JsonWriter
+{
+
+private:
+	// nesting level of an open object or array
+	struct Scope {
+		bool is_array;
+		bool is_empty;
+		int member_indent;		// indentation of members / elements
+		int close_indent;		// indentation of closing bracket
+	};
+
+	ofstream out;
+	string buffer;
+	size_t flush_threshold;
+	size_t total_bytes = 0;
+	bool write_failed = false;
+	vector<Scope> scopes;
+	// key was written, next call writes its value
+	bool after_key = false;
+	int key_indent = 0;
+	// no line breaks and indentation
+	bool compact = false;
+
+	void begin_scope(bool);
+	void end_scope();
+	// writes , and line break before next member or element (only , in compact layout)
+	void separator();
+	void indent(int);
+	void append_utf8(const wstring&, bool);
+	// text which already is UTF-8
+	void append_escaped(string_view);
+	void flush_if_needed();
+
+public:
+	/*************************************************************************************************************************************************************************
+	* Input:
+	*		flush_threshold		size_t		buffered bytes which trigger a write to file
+	*
+	*************************************************************************************************************************************************************************/
+	JsonWriter(size_t flush_threshold = 1 << 20);
+	~JsonWriter();
+
+
+	/*************************************************************************************************************************************************************************
+	* This function opens the output file
+	*
+	* Input:
+	*		json_path		wstring		where to store JSON file
+	* Output:
+	*		res				bool		success or not
+	*
+	*************************************************************************************************************************************************************************/
+	bool open(const wstring&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function writes the remaining buffer and closes the file
+	*
+	* Output:
+	*		res				bool		false if any write failed
+	*
+	*************************************************************************************************************************************************************************/
+	bool close();
+
+
+	/*************************************************************************************************************************************************************************
+	* This function selects the layout of the output
+	*
+	* Input:
+	*		compact			bool		true writes everything on one line without indentation (smaller files for the staging area),
+	*									false (default) the indented layout below, easier to read when debugging
+	*
+	*************************************************************************************************************************************************************************/
+	void set_compact(bool compact) { this->compact = compact; }
+
+
+	/*************************************************************************************************************************************************************************
+	* These functions write JSON structure
+	*
+	* Output is UTF-8, written into a reusable buffer and flushed to file whenever flush_threshold is exceeded.
+	* Commas, line breaks and indentation are added by the writer, so the caller only calls begin/end, key and values in order.
+	* Layout is the one Tembo reports always had: objects which are values of a key start on a new line one level deeper,
+	* arrays open on the line of their key.
+	*
+	* string_value escapes " \ and control characters, raw_value is written as it is (numbers)
+	* key and string_value of a string take UTF-8, e.g. pooled strings, values and limits of data objects, and copy it without conversion
+	*
+	*************************************************************************************************************************************************************************/
+	void begin_object();
+	void end_object();
+	void begin_array();
+	void end_array();
+	void key(const wstring&);
+	void key(string_view);
+	void string_value(const wstring&);
+	void string_value(string_view);
+	void raw_value(const wstring&);
+
+	// bytes produced so far (written + buffered)
+	size_t bytes_written() const { return total_bytes + buffer.size(); }
+};
+
@@ -0,0 +1,33 @@
+#include "LimitsIndex.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+void LimitsIndex::add(LimitRecord record) {
+	size_t position = index.insert(ConditionHash().with(record.name), records.size());
+	if (position == records.size()) {
+		records.push_back(move(record));
+	}
+	else {
+		records[position] = move(record);
+	}
+}
+
+const LimitRecord* LimitsIndex::find(const wstring& name) const {
+	size_t position = index.find(ConditionHash().with(name));
+	if (position == ConditionIndex::npos || records[position].name != name) {
+		return nullptr;
+	}
+	return &records[position];
+}
+
+void LimitsIndex::clear() {
+	records.clear();
+	index.clear();
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cmath>
+#include "ConditionHash.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* Limits of one parameter of testlimits.txt, prepared for the JSON
+*
+* Unit, scale and the scaled LSL/USL are resolved once when the limits file is read, csvs_to_json copies them into the limit object.
+* Units get_unit_scale rejects ([...]) are only marked, the error is reported when a CSV file uses the parameter (like before).
+*
+*************************************************************************************************************************************************************************/
+struct LimitRecord
+{
+	wstring name;
+	// TestNr as written in the limits file, test_number_value if it is a number
+	wstring test_number;
+	int test_number_value = 0;
+	bool has_test_number_value = false;
+	// Unit column and the unit / scale from get_unit_scale
+	wstring raw_unit;
+	// UTF-8, as written to the JSON
+	string unit;
+	int scale = 0;
+	bool unit_valid = true;
+	// LSL and USL scaled by the unit, UTF-8 as written to the JSON
+	string lower_limit;
+	string upper_limit;
+	// LSL, USL and Typ in the unit without prefix, NaN if the column is empty or NaN
+	double lower_limit_value = NAN;
+	double upper_limit_value = NAN;
+	double typical_value = NAN;
+	wstring typical;
+	wstring req_id;
+	wstring description;
+
+	// TestNr as number, throws like stoi if it isn't one
+	int get_test_number_value() const { return has_test_number_value ? test_number_value : stoi(test_number); }
+};
+
+
+/*************************************************************************************************************************************************************************
+* Compiled testlimits.txt, records in file order with a flat hash index by parameter name
+*
+* A parameter listed more than once keeps the position of its first line and the limits of its last line.
+*
+*************************************************************************************************************************************************************************/
+class LimitsIndex
+{
+
+private:
+	vector<LimitRecord> records;
+	ConditionIndex index;
+
+public:
+	// adds a record or replaces the record with the same name
+	void add(LimitRecord);
+
+	// record of a parameter, nullptr if the limits file doesn't have it
+	const LimitRecord* find(const wstring&) const;
+
+	const vector<LimitRecord>& get_records() const { return records; }
+	size_t size() const { return records.size(); }
+	bool empty() const { return records.empty(); }
+	void clear();
+};
+
@@ -0,0 +1,345 @@
+#include "LineReader.h"
+#include "ConversionCache.h"
+
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <locale>
+#include <codecvt>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+// Windows-1252 characters of bytes 0x80 - 0x9F, undefined bytes are mapped to the same code point like Windows does
+static const wchar_t cp1252_high[32] = {
+	0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+	0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178
+};
+
+LineReader::LineReader(size_t block_size) : block_size(block_size) {
+}
+
+LineReader::~LineReader() {
+	this->close();
+}
+
+bool LineReader::open(const wstring& path, ContentHash* content_hash) {
+	this->close();
+	this->content_hash = content_hash;
+	hashed_position = 0;
+#ifdef _WIN32
+	// files may still be open in the tester or an editor, they are not locked for writing, renaming or deleting
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+		FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	file_handle = file;
+#else
+	string utf8_path = wstring_convert<codecvt_utf8<wchar_t>>().to_bytes(path);
+	file_descriptor = ::open(utf8_path.c_str(), O_RDONLY);
+	if (file_descriptor < 0) {
+		return false;
+	}
+#endif
+	finished = false;
+	position = 0;
+	if (this->map_file()) {
+		block_mode = false;
+	}
+	else {
+		// read in blocks instead
+		block_mode = true;
+		end_of_file = false;
+		block.clear();
+		data = nullptr;
+		data_size = 0;
+		this->read_block();
+	}
+	this->skip_bom();
+	return true;
+}
+
+void LineReader::close() {
+#ifdef _WIN32
+	if (mapped_view != nullptr) {
+		UnmapViewOfFile(mapped_view);
+	}
+	if (mapping_handle != nullptr) {
+		CloseHandle(mapping_handle);
+	}
+	if (file_handle != nullptr) {
+		CloseHandle(file_handle);
+	}
+	mapping_handle = nullptr;
+	file_handle = nullptr;
+#else
+	if (mapped_view != nullptr) {
+		munmap(mapped_view, mapped_size);
+	}
+	if (file_descriptor >= 0) {
+		::close(file_descriptor);
+	}
+	file_descriptor = -1;
+#endif
+	mapped_view = nullptr;
+	mapped_size = 0;
+	data = nullptr;
+	data_size = 0;
+	position = 0;
+	finished = true;
+	content_hash = nullptr;
+	block.clear();
+	block.shrink_to_fit();
+}
+
+bool LineReader::map_file() {
+#ifdef _WIN32
+	LARGE_INTEGER file_size;
+	if (!GetFileSizeEx(file_handle, &file_size) || (unsigned long long)file_size.QuadPart > (size_t)-1) {
+		return false;
+	}
+	if (file_size.QuadPart == 0) {
+		// empty files can't be mapped
+		data = nullptr;
+		data_size = 0;
+		return true;
+	}
+	mapping_handle = CreateFileMappingW(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping_handle == NULL) {
+		mapping_handle = nullptr;
+		return false;
+	}
+	mapped_view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if (mapped_view == NULL) {
+		mapped_view = nullptr;
+		CloseHandle(mapping_handle);
+		mapping_handle = nullptr;
+		return false;
+	}
+	mapped_size = (size_t)file_size.QuadPart;
+#else
+	struct stat file_stat;
+	if (fstat(file_descriptor, &file_stat) != 0 || (unsigned long long)file_stat.st_size > (size_t)-1) {
+		return false;
+	}
+	if (file_stat.st_size == 0) {
+		// empty files can't be mapped
+		data = nullptr;
+		data_size = 0;
+		return true;
+	}
+	void* view = mmap(nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+	if (view == MAP_FAILED) {
+		return false;
+	}
+	madvise(view, (size_t)file_stat.st_size, MADV_SEQUENTIAL);
+	mapped_view = view;
+	mapped_size = (size_t)file_stat.st_size;
+#endif
+	data = (const char*)mapped_view;
+	data_size = mapped_size;
+	return true;
+}
+
+size_t LineReader::read_bytes(char* buffer, size_t count) {
+#ifdef _WIN32
+	DWORD bytes_read = 0;
+	DWORD chunk = count > 0x40000000 ? 0x40000000 : (DWORD)count;
+	if (!ReadFile(file_handle, buffer, chunk, &bytes_read, NULL)) {
+		return 0;
+	}
+	return bytes_read;
+#else
+	ssize_t bytes_read = ::read(file_descriptor, buffer, count);
+	return bytes_read > 0 ? (size_t)bytes_read : 0;
+#endif
+}
+
+bool LineReader::read_block() {
+	if (end_of_file) {
+		return false;
+	}
+	// move unread bytes to the front, grow buffer if a single line doesn't fit
+	size_t remaining = data_size - position;
+	if (remaining > 0 && position > 0) {
+		memmove(block.data(), block.data() + position, remaining);
+	}
+	size_t capacity = block_size;
+	while (capacity < remaining * 2) {
+		capacity *= 2;
+	}
+	if (block.size() < capacity) {
+		block.resize(capacity);
+	}
+	size_t bytes_read = this->read_bytes(block.data() + remaining, block.size() - remaining);
+	if (bytes_read == 0) {
+		end_of_file = true;
+	}
+	else if (content_hash != nullptr) {
+		content_hash->add(block.data() + remaining, bytes_read);
+	}
+	data = block.data();
+	data_size = remaining + bytes_read;
+	position = 0;
+	return bytes_read > 0;
+}
+
+void LineReader::skip_bom() {
+	if (data_size - position >= 3 && (unsigned char)data[position] == 0xEF && (unsigned char)data[position + 1] == 0xBB &&
+		(unsigned char)data[position + 2] == 0xBF) {
+		position += 3;
+	}
+}
+
+bool LineReader::next_line(string_view& line) {
+	if (finished) {
+		return false;
+	}
+	// data is nullptr for an empty file
+	const char* newline = data_size > position ? (const char*)memchr(data + position, '\n', data_size - position) : nullptr;
+	while (newline == nullptr && block_mode && this->read_block()) {
+		newline = (const char*)memchr(data + position, '\n', data_size - position);
+	}
+	size_t line_end;
+	if (newline == nullptr) {
+		// last line, returned even if empty
+		line_end = data_size;
+		finished = true;
+	}
+	else {
+		line_end = newline - data;
+	}
+	size_t line_begin = position;
+	position = finished ? data_size : line_end + 1;
+	if (line_end > line_begin && data[line_end - 1] == '\r') {
+		line_end--;
+	}
+	line = string_view(data + line_begin, line_end - line_begin);
+	// mapped bytes are hashed in parts behind the lines, while they are still in the cache
+	if (content_hash != nullptr && !block_mode && (finished || position - hashed_position >= (1 << 20))) {
+		content_hash->add(data + hashed_position, position - hashed_position);
+		hashed_position = position;
+	}
+	return true;
+}
+
+void LineReader::decode(string_view bytes, wstring& text) {
+	text.clear();
+	text.reserve(bytes.size());
+	const unsigned char* p = (const unsigned char*)bytes.data();
+	size_t n = bytes.size();
+	size_t i = 0;
+	while (i < n) {
+		unsigned char c = p[i];
+		if (c < 0x80) {
+			text += (wchar_t)c;
+			i++;
+			continue;
+		}
+		// try to read UTF-8 sequence
+		size_t length = 0;
+		unsigned long code_point = 0;
+		if (c >= 0xC2 && c <= 0xDF) {
+			length = 2;
+			code_point = c & 0x1F;
+		}
+		else if (c >= 0xE0 && c <= 0xEF) {
+			length = 3;
+			code_point = c & 0x0F;
+		}
+		else if (c >= 0xF0 && c <= 0xF4) {
+			length = 4;
+			code_point = c & 0x07;
+		}
+		bool valid = length != 0 && i + length <= n;
+		for (size_t k = 1; valid && k < length; k++) {
+			if ((p[i + k] & 0xC0) != 0x80) {
+				valid = false;
+			}
+			else {
+				code_point = (code_point << 6) | (p[i + k] & 0x3F);
+			}
+		}
+		// reject overlong sequences, surrogates and values above U+10FFFF
+		if (valid && ((length == 3 && code_point < 0x800) || (length == 4 && (code_point < 0x10000 || code_point > 0x10FFFF)) ||
+			(code_point >= 0xD800 && code_point <= 0xDFFF))) {
+			valid = false;
+		}
+		if (!valid) {
+			// single Windows-1252 byte
+			text += c < 0xA0 ? cp1252_high[c - 0x80] : (wchar_t)c;
+			i++;
+			continue;
+		}
+		if (code_point >= 0x10000 && sizeof(wchar_t) == 2) {
+			// UTF-16 surrogate pair
+			code_point -= 0x10000;
+			text += (wchar_t)(0xD800 + (code_point >> 10));
+			text += (wchar_t)(0xDC00 + (code_point & 0x3FF));
+		}
+		else {
+			text += (wchar_t)code_point;
+		}
+		i += length;
+	}
+}
+
+wstring LineReader::decode(string_view bytes) {
+	wstring text;
+	LineReader::decode(bytes, text);
+	return text;
+}
+
+void LineReader::encode(wstring_view text, string& bytes) {
+	bytes.clear();
+	bytes.reserve(text.size());
+	for (size_t i = 0; i < text.size(); i++) {
+		unsigned long c = (unsigned long)text[i];
+		if (c < 0x80) {
+			bytes += (char)c;
+			continue;
+		}
+		// combine UTF-16 surrogate pair (wchar_t is 16 bit on Windows)
+		if (c >= 0xD800 && c <= 0xDBFF && i + 1 < text.size()) {
+			unsigned long low = (unsigned long)text[i + 1];
+			if (low >= 0xDC00 && low <= 0xDFFF) {
+				c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+				i++;
+			}
+		}
+		if (c < 0x800) {
+			bytes += (char)(0xC0 | (c >> 6));
+			bytes += (char)(0x80 | (c & 0x3F));
+		}
+		else if (c < 0x10000) {
+			bytes += (char)(0xE0 | (c >> 12));
+			bytes += (char)(0x80 | ((c >> 6) & 0x3F));
+			bytes += (char)(0x80 | (c & 0x3F));
+		}
+		else {
+			bytes += (char)(0xF0 | (c >> 18));
+			bytes += (char)(0x80 | ((c >> 12) & 0x3F));
+			bytes += (char)(0x80 | ((c >> 6) & 0x3F));
+			bytes += (char)(0x80 | (c & 0x3F));
+		}
+	}
+}
+
+string LineReader::encode(wstring_view text) {
+	string bytes;
+	LineReader::encode(text, bytes);
+	return bytes;
+}
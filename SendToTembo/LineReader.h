@@ -0,0 +1,129 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+class ContentHash;
+class LineReader
+{
+
+private:
+#ifdef _WIN32
+	void* file_handle = nullptr;		// HANDLE
+	void* mapping_handle = nullptr;		// HANDLE
+#else
+	int file_descriptor = -1;
+#endif
+	void* mapped_view = nullptr;
+	size_t mapped_size = 0;
+
+	// bytes of the file, either the mapped view or the block buffer
+	const char* data = nullptr;
+	size_t data_size = 0;
+	size_t position = 0;
+	bool finished = true;
+	// hash of all bytes read so far and position up to which mapped bytes are added to it
+	ContentHash* content_hash = nullptr;
+	size_t hashed_position = 0;
+
+	// block mode, used if file can't be mapped
+	bool block_mode = false;
+	bool end_of_file = false;
+	vector<char> block;
+	size_t block_size;
+
+	bool map_file();
+	// reads next bytes behind the remaining ones in block, false if nothing could be read
+	bool read_block();
+	size_t read_bytes(char*, size_t);
+	void skip_bom();
+
+public:
+	/*************************************************************************************************************************************************************************
+	* Input:
+	*		block_size		size_t		size of the read buffer if file can't be memory mapped
+	*
+	*************************************************************************************************************************************************************************/
+	LineReader(size_t block_size = 4 << 20);
+	~LineReader();
+
+	LineReader(const LineReader&) = delete;
+	LineReader& operator=(const LineReader&) = delete;
+
+
+	/*************************************************************************************************************************************************************************
+	* This function opens a file for reading line by line
+	*
+	* Input:
+	*		path			wstring			file to read
+	*		content_hash	ContentHash*	if given, every byte of the file is added to it while the lines are read (optional)
+	* Output:
+	*		res				bool			false if file couldn't be opened
+	*
+	* File is memory mapped, if mapping fails (e.g. file too big for 32 bit address space) it's read in blocks of block_size.
+	* UTF-8 byte order mark at the beginning is skipped.
+	* content_hash has the whole file (including the byte order mark) once next_line returned the last line.
+	*
+	*************************************************************************************************************************************************************************/
+	bool open(const wstring&, ContentHash* content_hash = nullptr);
+	void close();
+
+
+	/*************************************************************************************************************************************************************************
+	* This function returns the next line without line break
+	*
+	* Output:
+	*		line		string_view		raw bytes of the line, valid until next call of next_line (block mode) or close
+	*		res			bool			false if there are no more lines
+	*
+	* Lines are split on \n, a \r in front of it is removed. Text behind the last \n is always returned as last line,
+	* even if it's empty. This is the same sequence of lines "while (inf) getline(inf, line)" used to process.
+	*
+	*************************************************************************************************************************************************************************/
+	bool next_line(string_view&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function decodes raw bytes to wstring
+	*
+	* Input:
+	*		bytes		string_view		raw bytes, e.g. line or single field of a line
+	* Output:
+	*		text		wstring			decoded text, buffer is reused
+	*
+	* Valid UTF-8 sequences are decoded as UTF-8, any other byte as Windows-1252 (e.g. 0xB5 micro sign of ANSI files).
+	* ASCII bytes are copied without any lookup.
+	*
+	*************************************************************************************************************************************************************************/
+	static void decode(string_view, wstring&);
+	static wstring decode(string_view);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function encodes wstring to UTF-8
+	*
+	* Input:
+	*		text		wstring_view	text, UTF-16 on Windows
+	* Output:
+	*		bytes		string			UTF-8 bytes, buffer is reused
+	*
+	* Used for text kept as UTF-8 until it is written to the JSON, e.g. values and limits of data objects.
+	*
+	*************************************************************************************************************************************************************************/
+	static void encode(wstring_view, string&);
+	static string encode(wstring_view);
+};
+
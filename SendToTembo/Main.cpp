@@ -7,7 +7,17 @@
 #include "DataReader.h"
 #include "CSVReader.h"
 #include "EFFReader.h"
+#include "InputCatalog.h"
+#include "ConversionCache.h"
+#include "ThreadPool.h"
+#include "StagingUploader.h"
+#include "Tracer.h"
+#include "WatchDaemon.h"
 #include <clocale>
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <sstream>
 
 /*************************************************************************************************************************************************************************
 * maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
@@ -21,54 +31,425 @@
 namespace filesys = std::experimental::filesystem;
 using namespace std;
 
-vector<wstring> getAllFilesInDir(const wstring &dirPath, const wstring &fileExt)
-{
-	// Create a vector of wstring
-	vector<wstring> listOfFiles;
+/*************************************************************************************************************************************************************************
+* This function converts one search path (30_RawData or a folder within it) and copies the reports to the staging area
+*
+* Input:
+*		search_path		string					path given on the command line
+*		start_time		clock::time_point		time 0 of the trace
+*		shared_pool		ThreadPool*				pool for the EFF and CSV files, nullptr starts pools of 'Threads' workers
+*		out				wostream&				console output of the conversion
+*		json_format		wstring					compact or pretty from the command line, empty uses 'JsonFormat' of Config_Tembo.txt
+*
+* If a report can't be converted (e.g. invalid unit), the other reports are still written and copied, then the first error is thrown.
+*
+*************************************************************************************************************************************************************************/
+static void convert_search_path(const string& search_path, Tracer::clock::time_point start_time, ThreadPool* shared_pool, wostream& out,
+	const wstring& json_format) {
+	// spans of all phases, written next to the report if 'Trace: 1' is set in Config_Tembo.txt
+	Tracer tracer(start_time);
+
+	vector<wstring> csv_files;
+	vector<wstring> png_files;
+	vector<wstring> mat_files;
+	vector<wstring> eff_files;
+	vector<wstring> test_limits_file;
+	LimitsIndex limits_struct;
+	vector<wstring> configs_file;
+	map<wstring, wstring> raw_configs_struct;
+	map<wstring, wstring> configs_struct;
+	wstring test_flow_folder{};
+	string path = search_path;
+	wstring wpath{};
+	//used for right click on a single folder
+	wstring searchpath(path.begin(), path.end());
+	bool is_manual_measurement_data = false;
+	DataReader dr;
+	dr.set_log_stream(&out);
+	// catalogs of 20_TestFlow and search path, each tree is walked only once
+	InputCatalog test_flow_catalog;
+	InputCatalog search_catalog;
 
-	try {
-		// Check if given path exists and points to a directory
-		if (filesys::exists(dirPath) && filesys::is_directory(dirPath))
-		{
-			// Create a Recursive Directory Iterator object and points to the starting of directory
-			filesys::recursive_directory_iterator iter(dirPath);
+	// check whether upload whole 30_RawData or just a single folder within it 
+	int sign = -1;
+	sign = path.find("30_RawData\\");
+	// right click on a single file 
+	if (sign != -1) {
+		path = path.replace(path.find_last_of("\\"), path.size() - 1, "");
+	}
+	wstring wsTmp(path.begin(), path.end());
+	wpath = wsTmp;
+	out << L"Path: " << wpath << endl;
+	// get test_flow folder
+	test_flow_folder = wpath;
+	test_flow_folder = test_flow_folder.replace(test_flow_folder.find_last_of(L"\\") + 1, test_flow_folder.size() - 1, L"20_TestFlow");
 
-			// Create a Recursive Directory Iterator object pointing to end.
-			filesys::recursive_directory_iterator end;
+	// catalog inputs
+	TraceSpan scan_span(&tracer, L"scan", L"scan_inputs");
+	scan_span.arg(L"folder", searchpath);
+	test_flow_catalog.scan(test_flow_folder);
+	search_catalog.scan(searchpath);
+	scan_span.counter(L"csv_files", search_catalog.get_csv_files().size());
+	scan_span.counter(L"eff_files", search_catalog.get_eff_files().size());
+	scan_span.counter(L"png_files", search_catalog.get_png_files().size());
+	scan_span.counter(L"mat_files", search_catalog.get_mat_files().size());
+	scan_span.end();
 
-			// Iterate till end
-			while (iter != end) {
-				// Check if current entry is a directory and if exists in skip list
-				if (filesys::is_directory(iter->path())) {
-					// Skip the iteration of current directory pointed by iterator
+	// read configs
+	TraceSpan config_span(&tracer, L"read", L"read_config_file");
+	configs_file = test_flow_catalog.get_config_files();
+	if (configs_file.size() > 0) {
+		raw_configs_struct = dr.read_config_file(configs_file[0]);
+	}
+	else {
+		out << L"Couldn't read Config_Tembo.txt file" << endl;
+	}
+	config_span.counter(L"configs", raw_configs_struct.size());
+	config_span.end();
+	// if basic_type is in raw_configs_struct then it is excel data (manual measurement)
+	// 'Cache: 0' turns off reusing parse results of unchanged files
+	bool use_cache = true;
+	// files copied to the staging area at the same time, 'StagingArea' replaces the share (e.g. local folder for testing)
+	unsigned int num_upload_threads = 4;
+	wstring staging_area_override{};
+	// 'Trace: 1' writes the spans of the conversion to trace.json (chrome://tracing)
+	bool use_trace = false;
+	// 'JsonFormat: compact' writes the reports without line breaks and indentation, pretty (default) keeps them readable
+	wstring config_json_format = L"pretty";
+	for (map<wstring, wstring>::value_type& config : raw_configs_struct) {
+		if (L"basic_type" == config.first) {
+			is_manual_measurement_data = true;
+		}
+		if (dr.convert_to_lower(config.first) == L"cache" && config.second == L"0") {
+			use_cache = false;
+		}
+		if (dr.convert_to_lower(config.first) == L"uploadthreads") {
+			try {
+				num_upload_threads = max(1, stoi(config.second));
+			}
+			catch (exception &e) {
+				out << L"Invalid UploadThreads value in Config_Tembo.txt, using 4" << endl;
+			}
+		}
+		if (dr.convert_to_lower(config.first) == L"stagingarea") {
+			staging_area_override = config.second;
+		}
+		if (dr.convert_to_lower(config.first) == L"trace" && config.second == L"1") {
+			use_trace = true;
+		}
+		if (dr.convert_to_lower(config.first) == L"jsonformat") {
+			config_json_format = dr.convert_to_lower(config.second);
+		}
+	}
+	bool compact_json = (json_format.empty() ? config_json_format : json_format) == L"compact";
+
+	time_t theTime = time(NULL);
+	struct tm *aTime = localtime(&theTime);
+	int day = aTime->tm_mday;
+	int month = aTime->tm_mon + 1;
+	int year = aTime->tm_year + 1900;
+	int hour = aTime->tm_hour;
+	int min = aTime->tm_min;
+	int sec = aTime->tm_sec;
+	string out_folder_name = "50_Report\\" + to_string(year) + to_string(month) + to_string(day) + "T" + to_string(hour) + to_string(min) + to_string(sec);
+
+	// get the output folder path
+	string out_folder_path = path.replace(path.find_last_of("\\") + 1, path.size() - 1, out_folder_name);
+	wstring wsTmp2(out_folder_path.begin(), out_folder_path.end());
+	wstring w_out_folder_path = wsTmp2;
+	out << L"Out folder: " << w_out_folder_path << endl;
+
+	// parse results are cached next to the reports, so a new run only parses files which changed
+	wstring cache_folder = w_out_folder_path.substr(0, w_out_folder_path.find_last_of(L"\\")) + L"\\.cache";
+	ConversionCache conversion_cache(use_cache ? cache_folder : L"");
+	ConversionCache* used_cache = conversion_cache.is_enabled() ? &conversion_cache : nullptr;
+	Tracer* used_tracer = use_trace ? &tracer : nullptr;
+
+	// files are copied in the background while the next files are converted, reports are printed at the end
+	unique_ptr<StagingUploader> eff_uploader;
+	unique_ptr<StagingUploader> csv_uploader;
+
+	// first error of the EFF or CSV conversion (e.g. invalid unit), rethrown once the other reports are copied
+	exception_ptr conversion_error;
+	if (CreateDirectory(out_folder_path.c_str(), NULL) || ERROR_ALREADY_EXISTS == GetLastError()) {
+		// read EFF files
+		eff_files = search_catalog.get_eff_files();
+		if (eff_files.size() > 0) {
+			// Input folder contains eff files
+			// setup configurations
+			configs_struct = dr.setup_configurations(raw_configs_struct, false);
+			wstring prj_name = configs_struct[L"Project"];
+			transform(prj_name.begin(), prj_name.end(), prj_name.begin(), ::toupper);
+			wstring staging_area = wstring(L"\\\\VIHSDV002.infineon.com\\tembo_staging_prod\\") + prj_name + L"\\job";
+			if (!staging_area_override.empty()) {
+				staging_area = staging_area_override;
+			}
+			eff_uploader.reset(new StagingUploader(unique_ptr<UploadDestination>(new FolderDestination(staging_area)), num_upload_threads));
+			eff_uploader->set_tracer(used_tracer);
+			// number of files converted in parallel, 0 uses all cores, not used with a shared pool
+			int num_threads = 0;
+			try {
+				num_threads = max(0, stoi(configs_struct[L"Threads"]));
+			}
+			catch (exception &e) {
+				out << L"Invalid Threads value in Config_Tembo.txt, using all cores" << endl;
+			}
+			// EFF files with the same name (e.g. in different subfolders) write the same report, so they are converted one after another
+			// in their original order and the last one wins, like in a serial run
+			map<wstring, size_t> report_groups;
+			vector<pair<wstring, vector<wstring>>> grouped_eff_files;
+			vector<uintmax_t> group_sizes;
+			for (auto eff_file : eff_files) {
+				// get report name from EFF file name
+				wstring base_filename = eff_file.substr(eff_file.find_last_of(L"/\\") + 1);
+				wstring::size_type const p(base_filename.find_last_of('.'));
+				wstring report_name = base_filename.substr(0, p);
+				// file names on Windows are not case sensitive
+				auto inserted = report_groups.insert(make_pair(dr.convert_to_lower(report_name), grouped_eff_files.size()));
+				if (inserted.second) {
+					grouped_eff_files.push_back(make_pair(report_name, vector<wstring>()));
+					group_sizes.push_back(0);
 				}
-				else {
-					// Add the name in vector
+				size_t group = inserted.first->second;
+				grouped_eff_files[group].second.push_back(eff_file);
+				error_code ec;
+				uintmax_t file_size = filesys::file_size(eff_file, ec);
+				group_sizes[group] += ec ? 0 : file_size;
+			}
+			// convert largest reports first, so a big file doesn't start last and keep one core busy alone
+			vector<size_t> group_order(grouped_eff_files.size());
+			for (size_t group = 0; group < group_order.size(); group++) {
+				group_order[group] = group;
+			}
+			stable_sort(group_order.begin(), group_order.end(), [&](size_t a, size_t b) { return group_sizes[a] > group_sizes[b]; });
+
+			// write each report separately, console output of each report is collected and printed in one piece
+			mutex console_mutex;
+			unique_ptr<ThreadPool> own_pool;
+			ThreadPool* pool = shared_pool;
+			if (pool == nullptr) {
+				own_pool.reset(new ThreadPool(num_threads));
+				pool = own_pool.get();
+			}
+			TaskGroup eff_tasks(*pool);
+			for (size_t group : group_order) {
+				wstring report_name = grouped_eff_files[group].first;
+				vector<wstring> group_files = grouped_eff_files[group].second;
+				eff_tasks.run([&, report_name, group_files]() {
+					wostringstream file_log;
+					bool any_written = false;
+					// e.g. invalid unit, the report isn't copied and the error is rethrown by eff_tasks.wait
+					exception_ptr error;
 					try {
-						if (iter->path().wstring().find(fileExt) != wstring::npos) {
-							listOfFiles.push_back(iter->path().wstring());
+						for (const wstring& eff_file : group_files) {
+							EFFReader er;
+							er.set_log_stream(&file_log);
+							er.set_conversion_cache(used_cache);
+							er.set_tracer(used_tracer);
+							er.set_compact_json(compact_json);
+							file_log << L"Reading EFF file: " << eff_file << endl;
+							if (er.eff_to_json(eff_file, configs_struct, w_out_folder_path)) {
+								file_log << L"Staging area location" << endl << staging_area << endl << endl;
+								any_written = true;
+							}
 						}
 					}
-					catch (invalid_argument &e) {
-						error_code ec;
-						iter.increment(ec);
+					catch (exception &e) {
+						error = current_exception();
+						file_log << L"Conversion of " << report_name << L" failed: " << e.what() << endl;
 					}
-				}
+					// move file to Tembo, once the last file of the report was written
+					if (any_written && !error) {
+						eff_uploader->add_last(w_out_folder_path + L"\\" + report_name + L".json");
+					}
+					{
+						lock_guard<mutex> lock(console_mutex);
+						out << file_log.str() << flush;
+					}
+					if (error) {
+						rethrow_exception(error);
+					}
+				});
+			}
+			try {
+				eff_tasks.wait();
+			}
+			catch (...) {
+				conversion_error = current_exception();
+			}
+		}
+		// read csv files
+		csv_files = search_catalog.get_csv_files();
+		// read all png files
+		png_files = search_catalog.get_png_files();
+		// read all mat files
+		mat_files = search_catalog.get_mat_files();
+		bool res;
+		if (csv_files.size() > 0) {
+			// Input folder contains csv files
+			CSVReader cr;
+			cr.set_log_stream(&out);
+			cr.set_conversion_cache(used_cache);
+			cr.set_tracer(used_tracer);
+			cr.set_thread_pool(shared_pool);
+			cr.set_compact_json(compact_json);
+			// use raw_configs_struct for manual measurement data, since it deals with default values
+			// for normal CSV file use configs_struct
+			if (!is_manual_measurement_data) {
+				configs_struct = dr.setup_configurations(raw_configs_struct, true);
+			}
+			else {
+				configs_struct = raw_configs_struct;
+			}
+			
+			// read limits
+			test_limits_file = test_flow_catalog.get_limits_files();
+			if (test_limits_file.size() > 0) {
+				limits_struct = cr.read_limits_file(test_limits_file[0]);
+			}
+			else {
+				out << L"Couldn't read testlimits.txt file" << endl;
+			}
 
-				error_code ec;
-				// Increment the iterator to point to next entry in recursive iteration
-				iter.increment(ec);
-				if (ec) {
-					cerr << "Error While Accessing : " << iter->path().string() << " :: " << ec.message() << '\n';
+			wstring prj_name = configs_struct[L"Project"];
+			transform(prj_name.begin(), prj_name.end(), prj_name.begin(), ::toupper);
+			wstring staging_area = wstring(L"\\\\VIHSDV002.infineon.com\\tembo_staging_prod\\") + prj_name + L"\\job";
+			if (!staging_area_override.empty()) {
+				staging_area = staging_area_override;
+			}
+			csv_uploader.reset(new StagingUploader(unique_ptr<UploadDestination>(new FolderDestination(staging_area)), num_upload_threads));
+			csv_uploader->set_tracer(used_tracer);
+			// move png and mat files while the JSON is generated, without the JSON they don't start a job in Tembo
+			for (auto png_file : png_files) {
+				if (dr.convert_to_lower(png_file).find(L"report-picture") != wstring::npos) {
+					csv_uploader->add(png_file);
+				}
+			}
+			for (auto mat_file : mat_files) {
+				if (dr.convert_to_lower(mat_file).find(L"report-waveform") != wstring::npos) {
+					csv_uploader->add(mat_file);
 				}
 			}
 
+			try {
+				res = cr.csvs_to_json(csv_files, limits_struct, configs_struct, w_out_folder_path, png_files, mat_files);
+			}
+			catch (exception &e) {
+				out << L"Conversion of CSV files failed: " << e.what() << endl;
+				conversion_error = current_exception();
+				res = false;
+			}
+			if (res) {
+				out << L"Staging area location" << endl << staging_area << endl << endl;
+
+				// move file to Tembo, after all png and mat files
+				wstring report_name = configs_struct[L"ReportName"];
+				csv_uploader->add_last(w_out_folder_path + L"\\" + report_name + L".json");
+			}
+		}
+		else {
+			out << L"Couldn't locate csv files" << endl;
+		}
+
+		// wait for the staging area copies
+		if (eff_uploader) {
+			eff_uploader->finish(out);
+		}
+		if (csv_uploader) {
+			csv_uploader->finish(out);
+		}
+
+		if (use_trace) {
+			wstring trace_path = w_out_folder_path + L"\\trace.json";
+			if (tracer.write(trace_path)) {
+				out << L"Trace is saved in " << endl << trace_path << endl << endl;
+			}
+			else {
+				out << L"Couldn't write trace file: " << trace_path << endl;
+			}
+		}
+
+		if (conversion_error) {
+			rethrow_exception(conversion_error);
 		}
 	}
-	catch (system_error & e) {
-		cerr << "Exception :: " << e.what();
+	else {
+		out << L"Failed to create directory!" << endl;
 	}
-	return listOfFiles;
+}
+
+
+/*************************************************************************************************************************************************************************
+* This function converts all search paths of a manifest on one shared thread pool
+*
+* Input:
+*		manifest_path	string					text file with one search path per line, empty lines and lines starting with # are skipped
+*		start_time		clock::time_point		time 0 of the traces
+*		json_format		wstring					compact or pretty from the command line, empty uses Config_Tembo.txt of each folder
+* Output:
+*		res				int						exit code, 0 if all folders were converted
+*
+* Folders and their EFF/CSV files are tasks of the same work stealing pool, so small folders fill the cores while a big one is still
+* running. Console output of each folder is printed in one piece when the folder is finished.
+* A folder which can't be converted (e.g. unreadable config or limits file, invalid unit) is listed as failed at the end, the readers
+* throw instead of exiting, so the other folders are still converted.
+*
+*************************************************************************************************************************************************************************/
+static int run_batch(const string& manifest_path, Tracer::clock::time_point start_time, const wstring& json_format) {
+	ifstream manifest(manifest_path);
+	if (!manifest) {
+		wcout << L"Couldn't read batch manifest: " << wstring(manifest_path.begin(), manifest_path.end()) << endl;
+		return 1;
+	}
+	vector<string> search_paths;
+	string line;
+	while (getline(manifest, line)) {
+		line.erase(0, line.find_first_not_of(" \t"));
+		line.erase(line.find_last_not_of(" \t\r\n") + 1);
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		search_paths.push_back(line);
+	}
+
+	ThreadPool pool;
+	wcout << L"Batch: " << search_paths.size() << L" folders on " << pool.size() << L" threads" << endl;
+	mutex console_mutex;
+	vector<wstring> failed_folders;
+	{
+		TaskGroup folder_tasks(pool);
+		for (const string& search_path : search_paths) {
+			folder_tasks.run([&, search_path]() {
+				wstring w_search_path(search_path.begin(), search_path.end());
+				wostringstream folder_log;
+				folder_log << L"SearchPath: " << w_search_path << endl;
+				bool failed = false;
+				try {
+					convert_search_path(search_path, start_time, &pool, folder_log, json_format);
+				}
+				catch (exception &e) {
+					folder_log << L"Conversion failed: " << e.what() << endl;
+					failed = true;
+				}
+				catch (...) {
+					folder_log << L"Conversion failed" << endl;
+					failed = true;
+				}
+				lock_guard<mutex> lock(console_mutex);
+				wcout << folder_log.str() << flush;
+				if (failed) {
+					failed_folders.push_back(w_search_path);
+				}
+			});
+		}
+		folder_tasks.wait();
+	}
+
+	wcout << L"Batch: " << search_paths.size() - failed_folders.size() << L" of " << search_paths.size() << L" folders converted" << endl;
+	for (const wstring& failed_folder : failed_folders) {
+		wcout << L"Failed: " << failed_folder << endl;
+	}
+	return failed_folders.empty() ? 0 : 1;
 }
 
 int main(int argc, char *argv[]) {
@@ -79,184 +460,57 @@ int main(int argc, char *argv[]) {
 	std::setlocale(LC_ALL, "en_US.utf8");
 	//std::locale::global(std::locale("en_US.utf8"));
 
-	vector<wstring> csv_files;
-	vector<wstring> png_files;
-	vector<wstring> mat_files;
-	vector<wstring> eff_files;
-	vector<wstring> test_limits_file;
-	map<wstring, map<wstring, wstring>> limits_struct;
-	vector<wstring> configs_file;
-	map<wstring, wstring> raw_configs_struct;
-	map<wstring, wstring> configs_struct;
-	wstring test_flow_folder{};
 	string path{};
-	wstring wpath{};
 	//used for right click on a single folder
 	wstring searchpath{};
 	bool use_sys_pause = true;
-	bool is_manual_measurement_data = false;
-	DataReader dr;
+	int exit_code = 0;
+	// JSON layout for the following search paths: --compact (one line, smaller upload) or --pretty (indented, for debugging)
+	wstring json_format{};
 	for (int i = 1; i < argc; i++) {
 		path = argv[i];
+		if (path == "--compact" || path == "--pretty") {
+			json_format = path == "--compact" ? L"compact" : L"pretty";
+			continue;
+		}
+		// long running mode for lab stations: --watch <30_RawData folder>
+		if (path == "--watch" && i + 1 == argc) {
+			wcout << L"Usage: --watch <30_RawData folder>" << endl;
+			return 1;
+		}
+		if (path == "--watch") {
+			string raw_data_path = argv[i + 1];
+			WatchDaemon daemon(wstring(raw_data_path.begin(), raw_data_path.end()));
+			daemon.set_json_format(json_format);
+			return daemon.run();
+		}
+		// nightly re-upload: --batch <manifest with one search path per line>
+		if (path == "--batch" && i + 1 == argc) {
+			wcout << L"Usage: --batch <manifest with one search path per line>" << endl;
+			return 1;
+		}
+		if (path == "--batch") {
+			int res = run_batch(argv[i + 1], t3, json_format);
+			cout << "Total time: " << mil(clock::now() - t3).count() << " ms" << endl;
+			return res;
+		}
 		wstring searchPathTmp(path.begin(), path.end());
 		searchpath = searchPathTmp;
 		wcout << "SearchPath: " << searchpath << endl;
-		// check whether upload whole 30_RawData or just a single folder within it 
-		int sign = -1;
-		sign = path.find("30_RawData\\");
-		// right click on a single file 
-		if (sign != -1) {
-			path = path.replace(path.find_last_of("\\"), path.size() - 1, "");
-		}
-		cout << "Path: " << path << endl;
-		wstring wsTmp(path.begin(), path.end());
-		wpath = wsTmp;
 		// check if input contains number. If it does remove system pause (another program is calling)
 		double doub;
-		wistringstream iss(wpath);
+		wistringstream iss(searchpath);
 		iss >> dec >> doub;
 		if (!iss.fail()) {
 			use_sys_pause = false;
 			continue;
 		}
-		// get test_flow folder
-		test_flow_folder = wpath;
-		test_flow_folder = test_flow_folder.replace(test_flow_folder.find_last_of(L"\\") + 1, test_flow_folder.size() - 1, L"20_TestFlow");
-
-		// read configs
-		configs_file = getAllFilesInDir(test_flow_folder, L"Config_Tembo.txt");
-		if (configs_file.size() > 0) {
-			raw_configs_struct = dr.read_config_file(configs_file[0]);
-		}
-		else {
-			cout << "Couldn't read Config_Tembo.txt file" << endl;
-		}
-		// if basic_type is in raw_configs_struct then it is excel data (manual measurement)
-		for (map<wstring, wstring>::value_type& config : raw_configs_struct) {
-			if (L"basic_type" == config.first) {
-				is_manual_measurement_data = true;
-			}
-		}
-
-		time_t theTime = time(NULL);
-		struct tm *aTime = localtime(&theTime);
-		int day = aTime->tm_mday;
-		int month = aTime->tm_mon + 1;
-		int year = aTime->tm_year + 1900;
-		int hour = aTime->tm_hour;
-		int min = aTime->tm_min;
-		int sec = aTime->tm_sec;
-		string out_folder_name = "50_Report\\" + to_string(year) + to_string(month) + to_string(day) + "T" + to_string(hour) + to_string(min) + to_string(sec);
-
-		// get the output folder path
-		string out_folder_path = path.replace(path.find_last_of("\\") + 1, path.size() - 1, out_folder_name);
-		cout << "Out folder: " << out_folder_path << endl;
-		wstring wsTmp2(out_folder_path.begin(), out_folder_path.end());
-		wstring w_out_folder_path = wsTmp2;
-
-		if (CreateDirectory(out_folder_path.c_str(), NULL) || ERROR_ALREADY_EXISTS == GetLastError()) {
-			// read EFF files
-			eff_files = getAllFilesInDir(searchpath, L".eff");
-			if (eff_files.size() > 0) {
-				// Input folder contains eff files
-				EFFReader er;
-				// setup configurations
-				configs_struct = dr.setup_configurations(raw_configs_struct, false);
-				bool res;
-				// write each file separately
-				for (auto eff_file : eff_files) {
-					wcout << L"Reading EFF file: " << eff_file << endl;
-					res = er.eff_to_json(eff_file, configs_struct, w_out_folder_path);
-					if (res) {
-						wstring prj_name = configs_struct[L"Project"];
-						transform(prj_name.begin(), prj_name.end(), prj_name.begin(), ::toupper);
-						wstring staging_area = wstring(L"\\\\VIHSDV002.infineon.com\\tembo_staging_prod\\") + prj_name + L"\\job";
-						wcout << L"Staging area location" << endl << staging_area << endl << endl;
-
-						// get report name from EFF file name
-						wstring base_filename = wstring(eff_file).substr(wstring(eff_file).find_last_of(L"/\\") + 1);
-						wstring::size_type const p(base_filename.find_last_of('.'));
-						wstring file_without_extension = base_filename.substr(0, p);
-						wstring report_name = file_without_extension;
-						
-						// move file to Tembo
-						try {
-							filesys::copy(w_out_folder_path + L"\\" + report_name + L".json", staging_area, filesys::copy_options::overwrite_existing);
-						}
-						catch (filesys::filesystem_error &e) {
-							cout << "Couldn't copy file to staging area: " << e.what() << endl;
-						}
-						
-					}
-				}
-			}
-			// read csv files
-			csv_files = getAllFilesInDir(searchpath, L".csv");
-			// read all png files
-			png_files = getAllFilesInDir(searchpath, L".png");
-			// read all mat files
-			mat_files = getAllFilesInDir(searchpath, L".mat");
-			bool res;
-			if (csv_files.size() > 0) {
-				// Input folder contains csv files
-				CSVReader cr;
-				// use raw_configs_struct for manual measurement data, since it deals with default values
-				// for normal CSV file use configs_struct
-				if (!is_manual_measurement_data) {
-					configs_struct = dr.setup_configurations(raw_configs_struct, true);
-				}
-				else {
-					configs_struct = raw_configs_struct;
-				}
-				
-				// read limits
-				test_limits_file = getAllFilesInDir(test_flow_folder, L"testlimits.txt");
-				if (test_limits_file.size() > 0) {
-					limits_struct = cr.read_limits_file(test_limits_file[0]);
-				}
-				else {
-					cout << "Couldn't read testlimits.txt file" << endl;
-				}
-				res = cr.csvs_to_json(csv_files, limits_struct, configs_struct, w_out_folder_path, png_files, mat_files);
-				if (res) {
-					wstring prj_name = configs_struct[L"Project"];
-					transform(prj_name.begin(), prj_name.end(), prj_name.begin(), ::toupper);
-					wstring staging_area = wstring(L"\\\\VIHSDV002.infineon.com\\tembo_staging_prod\\") + prj_name + L"\\job";
-					wcout << L"Staging area location" << endl << staging_area << endl << endl;
-
-					wstring report_name = configs_struct[L"ReportName"];
-					// move file to Tembo
-					try {
-						// move png files
-						for (auto png_file : png_files) {
-							if (dr.convert_to_lower(png_file).find(L"report-picture") != wstring::npos) {
-								filesys::copy(png_file, staging_area, filesys::copy_options::overwrite_existing);
-							}
-						}
-						// move mat files
-						for (auto mat_file : mat_files) {
-							if (dr.convert_to_lower(mat_file).find(L"report-waveform") != wstring::npos) {
-								filesys::copy(mat_file, staging_area, filesys::copy_options::overwrite_existing);
-							}
-						}
-						cout << "png and mat done" << endl;
-						filesys::copy(w_out_folder_path + L"\\" + report_name + L".json", staging_area, filesys::copy_options::overwrite_existing);
-					}
-					catch (filesys::filesystem_error &e) {
-						cout << "Couldn't copy file to staging area: " << e.what() << endl;
-						wcout << staging_area << endl;
-						wcout << w_out_folder_path + L"\\" + report_name + L".json" << endl;
-					}
-					
-				}
-			}
-			else {
-				wcout << L"Couldn't locate csv files" << endl;
-			}
-
+		try {
+			convert_search_path(path, t3, nullptr, wcout, json_format);
 		}
-		else {
-			wcout << L"Failed to create directory!" << endl;
+		catch (exception &e) {
+			wcout << L"Conversion failed: " << e.what() << endl;
+			exit_code = 1;
 		}
 	}
 
@@ -267,5 +521,5 @@ int main(int argc, char *argv[]) {
 		system("pause");
 	}
 
-	return 0;
+	return exit_code;
 }
\ No newline at end of file
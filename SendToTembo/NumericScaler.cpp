@@ -0,0 +1,143 @@
+#include "NumericScaler.h"
+
+#include <cstdio>
+#include <cstdlib>
+#if defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+size_t NumericScaler::to_ascii(wstring_view value, int scale, char* buffer, size_t buffer_size) {
+	size_t i = 0;
+	size_t n = value.size();
+	// skip leading blanks like stream >> does
+	while (i < n && (value[i] == ' ' || value[i] == '\t' || value[i] == '\r' || value[i] == '\n')) {
+		i++;
+	}
+	size_t length = 0;
+	// sign, from_chars doesn't accept leading +
+	if (i < n && (value[i] == '+' || value[i] == '-')) {
+		if (value[i] == '-') {
+			buffer[length++] = '-';
+		}
+		i++;
+	}
+	// mantissa, leave room for exponent. digits which don't fit are dropped (far beyond double precision),
+	// dropped digits in front of the point are added to the exponent
+	const size_t mantissa_size = buffer_size - 16;
+	size_t digits = 0;
+	bool has_point = false;
+	long dropped_digits = 0;
+	for (; i < n; i++) {
+		if (value[i] >= '0' && value[i] <= '9') {
+			if (length < mantissa_size) {
+				buffer[length++] = (char)value[i];
+			}
+			else if (!has_point) {
+				dropped_digits++;
+			}
+			digits++;
+		}
+		else if (value[i] == '.' && !has_point) {
+			if (length < mantissa_size) {
+				buffer[length++] = '.';
+			}
+			has_point = true;
+		}
+		else {
+			break;
+		}
+	}
+	if (digits == 0) {
+		return 0;
+	}
+	// exponent, only if followed by digits
+	long exponent = 0;
+	if (i < n && (value[i] == 'e' || value[i] == 'E')) {
+		size_t k = i + 1;
+		bool negative = false;
+		if (k < n && (value[k] == '+' || value[k] == '-')) {
+			negative = value[k] == '-';
+			k++;
+		}
+		if (k < n && value[k] >= '0' && value[k] <= '9') {
+			for (; k < n && value[k] >= '0' && value[k] <= '9'; k++) {
+				// big enough for over/underflow of any double, small enough to not overflow itself
+				if (exponent < 100000) {
+					exponent = exponent * 10 + (value[k] - '0');
+				}
+			}
+			if (negative) {
+				exponent = -exponent;
+			}
+		}
+	}
+	exponent += dropped_digits - scale;
+	if (exponent != 0) {
+		length += snprintf(buffer + length, buffer_size - length, "e%ld", exponent);
+	}
+	return length;
+}
+
+size_t NumericScaler::format(double value, char* buffer) {
+	size_t length = 0;
+#if defined(__cpp_lib_to_chars)
+	to_chars_result res = to_chars(buffer, buffer + 64, value);
+	length = res.ptr - buffer;
+#else
+	// shortest precision that reads back to the same value
+	for (int precision = 1; precision <= 17; precision++) {
+		length = snprintf(buffer, 64, "%.*g", precision, value);
+		if (strtod(buffer, nullptr) == value) {
+			break;
+		}
+	}
+#endif
+	return length;
+}
+
+double NumericScaler::parse(wstring_view value, int scale) {
+	char buffer[128];
+	size_t length = NumericScaler::to_ascii(value, scale, buffer, sizeof(buffer));
+	double number = 0;
+	if (length > 0) {
+#if defined(__cpp_lib_to_chars)
+		from_chars(buffer, buffer + length, number, chars_format::general);
+#else
+		buffer[length] = '\0';
+		number = strtod(buffer, nullptr);
+#endif
+	}
+	return number;
+}
+
+void NumericScaler::scale(int scale, wstring_view value, wstring& scaled) {
+	char buffer[64];
+	size_t length = NumericScaler::format(NumericScaler::parse(value, scale), buffer);
+	scaled.resize(length);
+	for (size_t i = 0; i < length; i++) {
+		scaled[i] = (wchar_t)buffer[i];
+	}
+}
+
+void NumericScaler::scale(int scale, wstring_view value, string& scaled) {
+	char buffer[64];
+	size_t length = NumericScaler::format(NumericScaler::parse(value, scale), buffer);
+	scaled.assign(buffer, length);
+}
+
+wstring NumericScaler::scale(int scale, wstring_view value) {
+	wstring scaled;
+	NumericScaler::scale(scale, value, scaled);
+	return scaled;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+class NumericScaler
+{
+
+private:
+	// writes number of value with decimal exponent reduced by scale into buffer, returns number of chars (0 = no number)
+	static size_t to_ascii(wstring_view, int, char*, size_t);
+	// parses number of value with exponent reduced by scale
+	static double parse(wstring_view, int);
+	// writes shortest text of value into buffer (64 chars), returns number of chars
+	static size_t format(double, char*);
+
+public:
+	/*************************************************************************************************************************************************************************
+	* This function scales a test value or limit by the SI scale of its unit
+	*
+	* Input:
+	*		scale		int				scale from DataReader::get_unit_scale, e.g. 3 for mV
+	*		value		wstring_view	value as read from file
+	* Output:
+	*		scaled		wstring			value * 10^-scale, buffer is reused (string: same text as ASCII, e.g. for DataObject::value)
+	*
+	* Value is parsed like stream >> double did (leading blanks and + allowed, parsing stops at first invalid char,
+	* nothing valid gives 0). Scaling is done on the text by shifting the decimal exponent before parsing (0.82068 uV is parsed
+	* as 0.82068e-6), so the result is rounded only once and there is no 8.206799999999999e-07 from multiplying.
+	* Result is written as shortest text that reads back to the same double.
+	* Uses from_chars/to_chars if the standard library has them, otherwise strtod and printf.
+	*
+	*************************************************************************************************************************************************************************/
+	static void scale(int, wstring_view, wstring&);
+	static void scale(int, wstring_view, string&);
+	static wstring scale(int, wstring_view);
+};
+
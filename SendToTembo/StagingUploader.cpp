@@ -0,0 +1,198 @@
+#include "StagingUploader.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+namespace filesys = std::experimental::filesystem;
+
+void FolderDestination::upload(const wstring& file) {
+	filesys::copy(file, folder, filesys::copy_options::overwrite_existing);
+}
+
+StagingUploader::StagingUploader(unique_ptr<UploadDestination> destination, unsigned int num_workers, int max_attempts,
+	chrono::milliseconds retry_delay) : destination(move(destination)), max_attempts(max(1, max_attempts)), retry_delay(retry_delay) {
+	if (num_workers == 0) {
+		num_workers = 1;
+	}
+	start_time = chrono::steady_clock::now();
+	for (unsigned int i = 0; i < num_workers; i++) {
+		workers.push_back(thread(&StagingUploader::worker_loop, this));
+	}
+}
+
+StagingUploader::~StagingUploader() {
+	{
+		unique_lock<mutex> lock(upload_mutex);
+		all_done.wait(lock, [this]() { return unfinished_uploads == 0; });
+		stopping = true;
+	}
+	upload_available.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void StagingUploader::add(const wstring& file) {
+	{
+		lock_guard<mutex> lock(upload_mutex);
+		Upload upload;
+		upload.file = file;
+		uploads.push_back(upload);
+		queued_files.push_back(uploads.size() - 1);
+		unfinished_files++;
+		unfinished_uploads++;
+	}
+	upload_available.notify_one();
+}
+
+void StagingUploader::add_last(const wstring& file) {
+	{
+		lock_guard<mutex> lock(upload_mutex);
+		Upload upload;
+		upload.file = file;
+		uploads.push_back(upload);
+		queued_last_files.push_back(uploads.size() - 1);
+		unfinished_uploads++;
+	}
+	upload_available.notify_one();
+}
+
+wstring StagingUploader::upload_with_retry(const wstring& file, int& attempts) {
+	wstring error;
+	chrono::milliseconds delay = retry_delay;
+	for (attempts = 1; attempts <= max_attempts; attempts++) {
+		try {
+			destination->upload(file);
+			return L"";
+		}
+		catch (exception &e) {
+			string what = e.what();
+			error = wstring(what.begin(), what.end());
+		}
+		if (attempts < max_attempts) {
+			this_thread::sleep_for(delay);
+			delay *= 2;
+		}
+	}
+	attempts = max_attempts;
+	return error;
+}
+
+void StagingUploader::worker_loop() {
+	while (true) {
+		size_t index;
+		bool is_last_file;
+		wstring file;
+		{
+			unique_lock<mutex> lock(upload_mutex);
+			upload_available.wait(lock, [this]() {
+				return stopping || !queued_files.empty() || (!queued_last_files.empty() && unfinished_files == 0);
+			});
+			if (!queued_files.empty()) {
+				index = queued_files.front();
+				queued_files.pop_front();
+				is_last_file = false;
+			}
+			else if (!queued_last_files.empty() && unfinished_files == 0) {
+				index = queued_last_files.front();
+				queued_last_files.pop_front();
+				is_last_file = true;
+				// JSON would start a job in Tembo without the pictures and waveforms it links
+				if (failed_files > 0) {
+					Upload& upload = uploads[index];
+					upload.skipped = true;
+					upload.error = L"skipped, " + to_wstring(failed_files) + L" files queued before couldn't be copied";
+					unfinished_uploads--;
+					if (unfinished_uploads == 0) {
+						all_done.notify_all();
+					}
+					continue;
+				}
+			}
+			else {
+				// stopping and nothing left to do
+				return;
+			}
+			file = uploads[index].file;
+		}
+
+		TraceSpan span(tracer, L"upload", L"staging copy");
+		span.arg(L"file", file);
+		int attempts = 0;
+		wstring error = this->upload_with_retry(file, attempts);
+		error_code ec;
+		uintmax_t file_size = filesys::file_size(file, ec);
+		span.counter(L"bytes", ec ? 0 : file_size);
+		span.counter(L"attempts", attempts);
+		span.counter(L"uploaded", error.empty() ? 1 : 0);
+		span.end();
+
+		{
+			lock_guard<mutex> lock(upload_mutex);
+			Upload& upload = uploads[index];
+			upload.attempts = attempts;
+			upload.uploaded = error.empty();
+			upload.error = error;
+			if (!is_last_file) {
+				unfinished_files--;
+				if (!upload.uploaded) {
+					failed_files++;
+				}
+			}
+			unfinished_uploads--;
+			if (unfinished_uploads == 0) {
+				all_done.notify_all();
+			}
+		}
+		// last files may be waiting for this one
+		if (!is_last_file) {
+			upload_available.notify_all();
+		}
+	}
+}
+
+bool StagingUploader::finish(wostream& out) {
+	vector<Upload> finished_uploads;
+	chrono::steady_clock::time_point end_time;
+	{
+		unique_lock<mutex> lock(upload_mutex);
+		all_done.wait(lock, [this]() { return unfinished_uploads == 0; });
+		finished_uploads.swap(uploads);
+		failed_files = 0;
+		end_time = chrono::steady_clock::now();
+	}
+	if (finished_uploads.empty()) {
+		return true;
+	}
+
+	size_t num_uploaded = 0;
+	int num_retries = 0;
+	for (const Upload& upload : finished_uploads) {
+		if (upload.uploaded) {
+			num_uploaded++;
+		}
+		if (!upload.skipped) {
+			num_retries += upload.attempts - 1;
+		}
+	}
+	out << L"Uploaded " << num_uploaded << L" of " << finished_uploads.size() << L" files to " << destination->get_location()
+		<< L" (" << num_retries << L" retries, " << chrono::duration<float, milli>(end_time - start_time).count() << L" ms)" << endl;
+	for (const Upload& upload : finished_uploads) {
+		if (upload.skipped) {
+			out << L"Didn't copy file to staging area, the files it links are missing: " << upload.file << endl;
+			out << L"\t" << upload.error << endl;
+		}
+		else if (!upload.uploaded) {
+			out << L"Couldn't copy file to staging area after " << upload.attempts << L" attempts: " << upload.file << endl;
+			out << L"\t" << upload.error << endl;
+		}
+	}
+	start_time = end_time;
+	return num_uploaded == finished_uploads.size();
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <experimental/filesystem>
+#include "Tracer.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* Place the converted files are uploaded to
+*
+* upload throws (e.g. filesystem_error) if the file couldn't be transferred, the uploader retries it then.
+* upload is called from several threads at the same time with different files.
+*
+*************************************************************************************************************************************************************************/
+class UploadDestination
+{
+
+public:
+	virtual ~UploadDestination() {}
+
+	// readable location for the console, e.g. path of the staging area
+	virtual wstring get_location() const = 0;
+	virtual void upload(const wstring& file) = 0;
+};
+
+
+/*************************************************************************************************************************************************************************
+* Destination folder, e.g. the tembo_staging_prod share or a local folder instead of the share for testing
+*
+* Files are copied into the folder with their file name, existing files are overwritten.
+*
+*************************************************************************************************************************************************************************/
+class FolderDestination : public UploadDestination
+{
+
+private:
+	wstring folder;
+
+public:
+	FolderDestination(const wstring& folder) : folder(folder) {}
+
+	wstring get_location() const override { return folder; }
+	void upload(const wstring& file) override;
+};
+
+
+/*************************************************************************************************************************************************************************
+* Uploads files to a destination in the background
+*
+* Files are handed out to num_workers threads, so copying to a slow share overlaps with the conversion and with other copies.
+* A failed upload is retried up to max_attempts times, the wait before a retry starts at retry_delay and doubles every attempt.
+* A failure doesn't stop other files.
+*
+* Files queued with add_last (the JSON reports) are started only when no file queued with add is waiting or uploading, since the
+* JSON starts the job in Tembo and the pictures and waveforms it links have to be there already. If any of these files couldn't be
+* copied, the files queued with add_last are skipped and reported by finish.
+*
+*************************************************************************************************************************************************************************/
+class StagingUploader
+{
+
+private:
+	struct Upload {
+		wstring file;
+		int attempts = 0;
+		bool uploaded = false;
+		// not copied since a file queued with add failed
+		bool skipped = false;
+		wstring error;
+	};
+
+	unique_ptr<UploadDestination> destination;
+	int max_attempts;
+	chrono::milliseconds retry_delay;
+	vector<thread> workers;
+
+	mutex upload_mutex;
+	condition_variable upload_available;
+	condition_variable all_done;
+	// indices into uploads, files and files which have to wait for them
+	deque<size_t> queued_files;
+	deque<size_t> queued_last_files;
+	vector<Upload> uploads;
+	// files queued with add and not finished yet
+	size_t unfinished_files = 0;
+	// files queued with add which couldn't be copied
+	size_t failed_files = 0;
+	size_t unfinished_uploads = 0;
+	bool stopping = false;
+	chrono::steady_clock::time_point start_time;
+	Tracer* tracer = nullptr;
+
+	void worker_loop();
+	// uploads one file with retries, returns error of the last attempt or empty string
+	wstring upload_with_retry(const wstring& file, int& attempts);
+
+public:
+	/*************************************************************************************************************************************************************************
+	* Starts the upload workers
+	*
+	* Input:
+	*		destination		unique_ptr<UploadDestination>		where the files go
+	*		num_workers		unsigned int						number of files uploaded at the same time, 0 = 1
+	*		max_attempts	int									attempts per file before it counts as failed
+	*		retry_delay		chrono::milliseconds				wait before the first retry
+	*
+	*************************************************************************************************************************************************************************/
+	StagingUploader(unique_ptr<UploadDestination>, unsigned int num_workers = 4, int max_attempts = 4,
+		chrono::milliseconds retry_delay = chrono::milliseconds(1000));
+
+	// waits for all queued files and joins the workers
+	~StagingUploader();
+
+	StagingUploader(const StagingUploader&) = delete;
+	StagingUploader& operator=(const StagingUploader&) = delete;
+
+	wstring get_location() const { return destination->get_location(); }
+
+	// adds a span per uploaded file, call before the first add
+	void set_tracer(Tracer* tracer) { this->tracer = tracer; }
+
+	// queues a file (png, mat), upload starts as soon as a worker is free
+	void add(const wstring& file);
+
+	// queues a file (JSON) which is uploaded only after all files queued with add
+	void add_last(const wstring& file);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function waits for all queued files and writes the completion report
+	*
+	* Input:
+	*		out			wostream&		stream for the report (number of uploaded files, retries, every failed or skipped file with its error)
+	* Output:
+	*		res			bool			whether all files were uploaded
+	*
+	* Files can be queued again afterwards, the next report only covers the new files.
+	*
+	*************************************************************************************************************************************************************************/
+	bool finish(wostream&);
+};
+
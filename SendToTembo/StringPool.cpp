@@ -0,0 +1,55 @@
+#include "StringPool.h"
+#include "LineReader.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+StringPool::StringPool() {
+}
+
+StringPool::~StringPool() {
+}
+
+PooledString StringPool::intern(wstring_view value) {
+	if (value.empty()) {
+		return StringPool::empty();
+	}
+	// encoded into a buffer of the thread, only strings which aren't in the pool yet are copied
+	thread_local string bytes;
+	LineReader::encode(value, bytes);
+	return this->intern(bytes);
+}
+
+PooledString StringPool::intern(const string& value) {
+	if (value.empty()) {
+		return StringPool::empty();
+	}
+	Shard& shard = this->shard_of(value);
+	lock_guard<mutex> lock(shard.shard_mutex);
+	// find first, so existing strings are not copied
+	auto found = shard.strings.find(value);
+	if (found != shard.strings.end()) {
+		return &*found;
+	}
+	return &*shard.strings.insert(value).first;
+}
+
+PooledString StringPool::empty() {
+	static const string empty_string;
+	return &empty_string;
+}
+
+size_t StringPool::size() {
+	size_t num_strings = 0;
+	for (Shard& shard : shards) {
+		lock_guard<mutex> lock(shard.shard_mutex);
+		num_strings += shard.strings.size();
+	}
+	return num_strings;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <mutex>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+// handle of an interned string (UTF-8), equal strings of one pool have equal handles
+typedef const string* PooledString;
+
+#pragma once
+class StringPool
+{
+
+private:
+	// strings are split by hash into shards with a lock each, so parallel readers interning into the same pool (e.g. CSV files parsed
+	// in parallel) rarely wait for each other. Node based set, addresses of stored strings never change
+	struct Shard {
+		unordered_set<string> strings;
+		mutex shard_mutex;
+	};
+	static const size_t num_shards = 32;
+	Shard shards[num_shards];
+
+	Shard& shard_of(const string& value) { return shards[hash<string>()(value) % num_shards]; }
+
+public:
+	StringPool();
+	~StringPool();
+
+	StringPool(const StringPool&) = delete;
+	StringPool& operator=(const StringPool&) = delete;
+
+
+	/*************************************************************************************************************************************************************************
+	* This function stores a string once and returns its handle
+	*
+	* Input:
+	*		value		wstring / string	string to intern, wstring is encoded to UTF-8, string already is UTF-8
+	* Output:
+	*		handle		PooledString		pointer to the stored UTF-8 copy, valid as long as the pool exists
+	*
+	* Strings are kept the way they are written to the JSON, so keys and values repeated over many data objects are encoded once
+	* when they are interned and not for every object again.
+	* Thread safe, the same pool can be shared by readers of parallel conversions
+	*
+	*************************************************************************************************************************************************************************/
+	PooledString intern(wstring_view);
+	PooledString intern(const string&);
+
+	// handle of the empty string, same for all pools
+	static PooledString empty();
+
+	// number of distinct strings
+	size_t size();
+};
+
@@ -0,0 +1,141 @@
+#include "TestNumberRegistry.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+namespace filesys = std::experimental::filesystem;
+
+shared_ptr<TestNumberRegistry::Store> TestNumberRegistry::open_store(const wstring& path) {
+	static mutex stores_mutex;
+	static map<wstring, shared_ptr<Store>> stores;
+	lock_guard<mutex> lock(stores_mutex);
+	shared_ptr<Store>& store = stores[path];
+	if (store) {
+		return store;
+	}
+	store = make_shared<Store>();
+	store->path = path;
+	LineReader inf;
+	if (inf.open(path)) {
+		string_view raw_line;
+		wstring line;
+		while (inf.next_line(raw_line)) {
+			LineReader::decode(raw_line, line);
+			size_t tab = line.find_last_of(L'\t');
+			if (tab == wstring::npos || tab == 0) {
+				continue;
+			}
+			try {
+				int number = stoi(line.substr(tab + 1));
+				store->numbers[line.substr(0, tab)] = number;
+				store->taken.insert(number);
+			}
+			catch (exception &e) {
+				continue;
+			}
+		}
+	}
+	return store;
+}
+
+void TestNumberRegistry::reserve(const LimitsIndex& limits) {
+	for (const LimitRecord& limit : limits.get_records()) {
+		if (limit.has_test_number_value) {
+			used.insert(limit.test_number_value);
+		}
+	}
+}
+
+void TestNumberRegistry::use_store(const wstring& path) {
+	store = open_store(path);
+}
+
+int TestNumberRegistry::first_free(int from) const {
+	int number = from;
+	while (used.count(number) != 0 || (store && store->taken.count(number) != 0)) {
+		number++;
+	}
+	return number;
+}
+
+int TestNumberRegistry::allocate(const wstring& name, bool leave_gap, bool stored) {
+	unique_lock<mutex> lock;
+	if (store) {
+		lock = unique_lock<mutex>(store->store_mutex);
+	}
+	// number of an earlier run, unless the limits file took it meanwhile
+	if (stored && store) {
+		auto stored_number = store->numbers.find(name);
+		if (stored_number != store->numbers.end() && used.count(stored_number->second) == 0) {
+			used.insert(stored_number->second);
+			numbers[name] = stored_number->second;
+			return stored_number->second;
+		}
+	}
+	int number = this->first_free(next_number);
+	if (leave_gap) {
+		number = this->first_free(number + 1);
+	}
+	used.insert(number);
+	next_number = number + 1;
+	numbers[name] = number;
+	if (stored && store) {
+		store->numbers[name] = number;
+		store->taken.insert(number);
+		store->changed = true;
+	}
+	return number;
+}
+
+void TestNumberRegistry::assign(const wstring& name, int number) {
+	used.insert(number);
+	numbers[name] = number;
+}
+
+bool TestNumberRegistry::find(const wstring& name, int& number) const {
+	auto found = numbers.find(name);
+	if (found == numbers.end()) {
+		return false;
+	}
+	number = found->second;
+	return true;
+}
+
+bool TestNumberRegistry::save() {
+	if (!store) {
+		return true;
+	}
+	lock_guard<mutex> lock(store->store_mutex);
+	if (!store->changed) {
+		return true;
+	}
+	wstring temp_path = store->path + L".tmp";
+	{
+		ofstream out(temp_path, ios::out | ios::binary | ios::trunc);
+		if (!out.is_open()) {
+			return false;
+		}
+		wstring_convert<codecvt_utf8<wchar_t>> to_utf8;
+		for (const auto& stored_number : store->numbers) {
+			out << to_utf8.to_bytes(stored_number.first) << '\t' << stored_number.second << "\r\n";
+		}
+		if (!out) {
+			return false;
+		}
+	}
+	error_code ec;
+	filesys::remove(store->path, ec);
+	filesys::rename(temp_path, store->path, ec);
+	if (ec) {
+		filesys::remove(temp_path, ec);
+		return false;
+	}
+	store->changed = false;
+	return true;
+}
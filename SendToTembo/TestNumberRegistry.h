@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <codecvt>
+#include <experimental/filesystem>
+#include "LimitsIndex.h"
+#include "LineReader.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* Test numbers of the parameters of one report
+*
+* Numbers of testlimits.txt are reserved up front, a parameter without limits never gets a number of the limits file. New numbers are
+* handed out from a counter which only moves forward, finding a free number is O(1) on average.
+*
+* With a store (use_store), parameters without limits keep the number they got in earlier runs. The store is a text file with one
+* "parameter<TAB>number" line per parameter (e.g. 50_Report\test_numbers.txt of a project). Registries of the same process using the
+* same file share one copy of it, so reports converted in parallel (e.g. batch mode) give a new parameter the same number.
+* Numbers of the store are never handed out to other parameters.
+*
+*************************************************************************************************************************************************************************/
+class TestNumberRegistry
+{
+
+private:
+	struct Store {
+		mutex store_mutex;
+		wstring path;
+		map<wstring, int> numbers;
+		unordered_set<int> taken;
+		bool changed = false;
+	};
+
+	// number of every parameter of the report
+	unordered_map<wstring, int> numbers;
+	// numbers of the limits file and numbers given to parameters
+	unordered_set<int> used;
+	int next_number = 1;
+	shared_ptr<Store> store;
+
+	// store of a file, read when the first registry of the process uses it
+	static shared_ptr<Store> open_store(const wstring& path);
+	// first number >= from which is neither used nor in the store, store_mutex has to be locked
+	int first_free(int from) const;
+
+public:
+	// reserves a number, e.g. TestNr of testlimits.txt
+	void reserve(int number) { used.insert(number); }
+	// reserves all numeric TestNr of the limits file
+	void reserve(const LimitsIndex&);
+
+	// keeps numbers of parameters without limits in the given file
+	void use_store(const wstring& path);
+	bool has_store() const { return store != nullptr; }
+
+
+	/*************************************************************************************************************************************************************************
+	* This function hands out the number of a new parameter
+	*
+	* Input:
+	*		name			wstring			parameter name
+	*		leave_gap		bool			skip the next free number (numbering of earlier versions was 1, 3, 5, ...)
+	*		stored			bool			parameter without limits, use and keep its number in the store
+	* Output:
+	*		number			int				number of the parameter, it's used afterwards
+	*
+	*************************************************************************************************************************************************************************/
+	int allocate(const wstring&, bool, bool);
+
+	// registers a parameter with a number of the limits file
+	void assign(const wstring& name, int number);
+
+	// number of a parameter which was allocated or assigned before
+	bool find(const wstring& name, int& number) const;
+
+	bool empty() const { return numbers.empty(); }
+
+
+	/*************************************************************************************************************************************************************************
+	* This function writes the store, if new parameters were added
+	*
+	* Output:
+	*		res			bool			false if the store couldn't be written
+	*
+	* The file is written to a temporary file first and renamed, an interrupted run keeps the previous numbers.
+	*
+	*************************************************************************************************************************************************************************/
+	bool save();
+};
+
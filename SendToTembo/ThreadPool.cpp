@@ -0,0 +1,176 @@
+#include "ThreadPool.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+namespace {
+	// pool and queue of the worker running on this thread, nullptr for other threads
+	thread_local ThreadPool* current_pool = nullptr;
+	thread_local size_t current_worker = 0;
+}
+
+ThreadPool::ThreadPool(unsigned int num_threads) {
+	if (num_threads == 0) {
+		num_threads = thread::hardware_concurrency();
+	}
+	if (num_threads == 0) {
+		num_threads = 1;
+	}
+	worker_tasks.resize(num_threads);
+	for (unsigned int i = 0; i < num_threads; i++) {
+		workers.push_back(thread(&ThreadPool::worker_loop, this, (size_t)i));
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		unique_lock<mutex> lock(pool_mutex);
+		state_changed.wait(lock, [this]() { return unfinished_tasks == 0; });
+		stopping = true;
+	}
+	task_available.notify_all();
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::submit(function<void()> task) {
+	this->enqueue(move(task), nullptr);
+}
+
+void ThreadPool::enqueue(function<void()> work, TaskGroup* group) {
+	lock_guard<mutex> lock(pool_mutex);
+	unfinished_tasks++;
+	if (group != nullptr) {
+		group->unfinished_tasks++;
+	}
+	if (current_pool == this) {
+		worker_tasks[current_worker].push_back(Task{ move(work), group });
+	}
+	else {
+		shared_tasks.push_back(Task{ move(work), group });
+	}
+	task_available.notify_one();
+	state_changed.notify_all();
+}
+
+void ThreadPool::wait() {
+	unique_lock<mutex> lock(pool_mutex);
+	state_changed.wait(lock, [this]() { return unfinished_tasks == 0; });
+	if (task_error) {
+		exception_ptr error = task_error;
+		task_error = nullptr;
+		rethrow_exception(error);
+	}
+}
+
+void ThreadPool::run_until(const function<bool()>& done) {
+	bool is_worker = current_pool == this;
+	unique_lock<mutex> lock(pool_mutex);
+	while (!done()) {
+		// tasks from outside the pool (e.g. the next folder) aren't started here, the waiting task would have to wait for all of it
+		Task task;
+		if (is_worker && this->pop_task(true, task)) {
+			lock.unlock();
+			this->run_task(task);
+			lock.lock();
+			continue;
+		}
+		state_changed.wait(lock);
+	}
+}
+
+bool ThreadPool::pop_task(bool nested_only, Task& task) {
+	size_t num_workers = worker_tasks.size();
+	// oldest own task first, callers submit in the order they want to be run (e.g. largest EFF file first)
+	if (current_pool == this && !worker_tasks[current_worker].empty()) {
+		task = move(worker_tasks[current_worker].front());
+		worker_tasks[current_worker].pop_front();
+		return true;
+	}
+	// steal the oldest task of another worker
+	for (size_t i = 1; i <= num_workers; i++) {
+		deque<Task>& other_tasks = worker_tasks[(current_worker + i) % num_workers];
+		if (!other_tasks.empty()) {
+			task = move(other_tasks.front());
+			other_tasks.pop_front();
+			return true;
+		}
+	}
+	if (!nested_only && !shared_tasks.empty()) {
+		task = move(shared_tasks.front());
+		shared_tasks.pop_front();
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::run_task(Task& task) {
+	exception_ptr error;
+	try {
+		task.work();
+	}
+	catch (...) {
+		error = current_exception();
+	}
+	// release captures before the group can be gone
+	task.work = nullptr;
+
+	lock_guard<mutex> lock(pool_mutex);
+	exception_ptr& first_error = task.group != nullptr ? task.group->task_error : task_error;
+	if (error && !first_error) {
+		first_error = error;
+	}
+	if (task.group != nullptr) {
+		task.group->unfinished_tasks--;
+	}
+	unfinished_tasks--;
+	state_changed.notify_all();
+}
+
+void ThreadPool::worker_loop(size_t index) {
+	current_pool = this;
+	current_worker = index;
+	unique_lock<mutex> lock(pool_mutex);
+	while (true) {
+		Task task;
+		if (this->pop_task(false, task)) {
+			lock.unlock();
+			this->run_task(task);
+			lock.lock();
+			continue;
+		}
+		if (stopping) {
+			// nothing left to do
+			return;
+		}
+		task_available.wait(lock);
+	}
+}
+
+TaskGroup::~TaskGroup() {
+	pool.run_until([this]() { return unfinished_tasks == 0; });
+}
+
+void TaskGroup::run(function<void()> task) {
+	pool.enqueue(move(task), this);
+}
+
+void TaskGroup::wait() {
+	pool.run_until([this]() { return unfinished_tasks == 0; });
+	exception_ptr error;
+	{
+		lock_guard<mutex> lock(pool.pool_mutex);
+		error = task_error;
+		task_error = nullptr;
+	}
+	if (error) {
+		rethrow_exception(error);
+	}
+}
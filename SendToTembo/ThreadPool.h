@@ -0,0 +1,151 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+class TaskGroup;
+
+/*************************************************************************************************************************************************************************
+* Work stealing thread pool
+*
+* Every worker has a queue of its own. A task submitted by a task (e.g. CSV files of a folder) goes to the queue of the worker running
+* it, the worker and idle workers stealing from it take the oldest task first, so tasks start in the order they were submitted.
+* Tasks submitted from outside the pool (e.g. folders of a batch) are started in the order they were submitted as well, after the
+* tasks submitted by tasks.
+* A task which has to wait for other tasks uses a TaskGroup, while waiting its worker runs queued tasks of the workers instead of blocking.
+*
+*************************************************************************************************************************************************************************/
+class ThreadPool
+{
+	friend class TaskGroup;
+
+private:
+	struct Task {
+		function<void()> work;
+		// group the task belongs to, nullptr for submit()
+		TaskGroup* group;
+	};
+
+	vector<thread> workers;
+	// one queue per worker for tasks submitted by tasks
+	vector<deque<Task>> worker_tasks;
+	// tasks submitted from outside the pool
+	deque<Task> shared_tasks;
+	mutex pool_mutex;
+	condition_variable task_available;
+	// a task was queued or finished, waiting threads check their condition again
+	condition_variable state_changed;
+	// number of tasks queued or running
+	size_t unfinished_tasks = 0;
+	bool stopping = false;
+	// first exception thrown by a task of submit(), rethrown by wait()
+	exception_ptr task_error;
+
+	void worker_loop(size_t index);
+	void enqueue(function<void()> work, TaskGroup* group);
+	// takes the next task, pool_mutex has to be locked. nested_only skips tasks submitted from outside the pool
+	bool pop_task(bool nested_only, Task& task);
+	void run_task(Task& task);
+
+public:
+	/*************************************************************************************************************************************************************************
+	* Starts a fixed number of worker threads
+	*
+	* Input:
+	*		num_threads		unsigned int		number of workers, 0 = number of cores
+	*
+	*************************************************************************************************************************************************************************/
+	ThreadPool(unsigned int num_threads = 0);
+
+	// waits for all queued tasks and joins the workers
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+
+	/*************************************************************************************************************************************************************************
+	* This function queues a task
+	*
+	* Input:
+	*		task		function<void()>		work to be done by one of the workers
+	*
+	*************************************************************************************************************************************************************************/
+	void submit(function<void()>);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function blocks until all submitted tasks are finished
+	*
+	* If any task threw an exception, the first one is rethrown here. Not to be called from a task, tasks wait with a TaskGroup.
+	*
+	*************************************************************************************************************************************************************************/
+	void wait();
+
+
+	/*************************************************************************************************************************************************************************
+	* This function blocks until a condition is true
+	*
+	* Input:
+	*		done		function<bool()>		condition, called with the pool locked, so it must not submit tasks
+	*
+	* The condition is checked again every time a task is queued or finished, state it depends on has to be changed by tasks of this pool.
+	* Called from a worker, the worker runs tasks submitted by tasks meanwhile.
+	*
+	*************************************************************************************************************************************************************************/
+	void run_until(const function<bool()>&);
+
+	size_t size() const { return workers.size(); }
+};
+
+
+/*************************************************************************************************************************************************************************
+* Tasks of a thread pool which are waited for together, e.g. the files of one folder
+*
+* Several groups can use the same pool at the same time, wait() only waits for the tasks of its own group. The destructor waits as well,
+* so tasks can use local variables of the function which created the group.
+*
+*************************************************************************************************************************************************************************/
+class TaskGroup
+{
+	friend class ThreadPool;
+
+private:
+	ThreadPool& pool;
+	// guarded by the mutex of the pool
+	size_t unfinished_tasks = 0;
+	exception_ptr task_error;
+
+public:
+	TaskGroup(ThreadPool& pool) : pool(pool) {}
+	// waits for the tasks of the group, exceptions are dropped
+	~TaskGroup();
+
+	TaskGroup(const TaskGroup&) = delete;
+	TaskGroup& operator=(const TaskGroup&) = delete;
+
+	ThreadPool& get_pool() { return pool; }
+
+	// queues a task of the group
+	void run(function<void()>);
+
+	// blocks until all tasks of the group are finished, rethrows the first exception thrown by one of them
+	void wait();
+};
@@ -0,0 +1,147 @@
+#include "Tokenizer.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define TOKENIZER_AVX2
+#define TOKENIZER_SSE2
+#elif defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TOKENIZER_SSE2
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+#ifdef TOKENIZER_SSE2
+// index of lowest set bit, bits must not be 0
+static inline unsigned int lowest_bit(unsigned int bits) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return index;
+#else
+	return __builtin_ctz(bits);
+#endif
+}
+
+// movemask returns one bit per byte, keep only the lowest bit of each wchar_t
+static const unsigned int char_bit_mask = sizeof(wchar_t) == 2 ? 0x55555555u : 0x11111111u;
+
+static inline __m128i set_char_128(wchar_t c) {
+	return sizeof(wchar_t) == 2 ? _mm_set1_epi16((short)c) : _mm_set1_epi32((int)c);
+}
+
+static inline __m128i equal_chars_128(__m128i a, __m128i b) {
+	return sizeof(wchar_t) == 2 ? _mm_cmpeq_epi16(a, b) : _mm_cmpeq_epi32(a, b);
+}
+#endif
+
+#ifdef TOKENIZER_AVX2
+static inline __m256i set_char_256(wchar_t c) {
+	return sizeof(wchar_t) == 2 ? _mm256_set1_epi16((short)c) : _mm256_set1_epi32((int)c);
+}
+
+static inline __m256i equal_chars_256(__m256i a, __m256i b) {
+	return sizeof(wchar_t) == 2 ? _mm256_cmpeq_epi16(a, b) : _mm256_cmpeq_epi32(a, b);
+}
+#endif
+
+// delimiter found at pos, adds token in front of it
+static inline void add_token(const wchar_t* line, size_t pos, bool collapse_delimiters, size_t& token_start, vector<wstring_view>& tokens) {
+	if (!collapse_delimiters || pos > token_start) {
+		tokens.push_back(wstring_view(line + token_start, pos - token_start));
+	}
+	token_start = pos + 1;
+}
+
+void Tokenizer::split_scalar(const wchar_t* line, size_t begin, size_t end, wstring_view delimiters, bool collapse_delimiters,
+							size_t& token_start, vector<wstring_view>& tokens) {
+	if (delimiters.size() == 1) {
+		wchar_t delimiter = delimiters[0];
+		for (size_t i = begin; i < end; i++) {
+			if (line[i] == delimiter) {
+				add_token(line, i, collapse_delimiters, token_start, tokens);
+			}
+		}
+		return;
+	}
+	for (size_t i = begin; i < end; i++) {
+		if (delimiters.find(line[i]) != wstring_view::npos) {
+			add_token(line, i, collapse_delimiters, token_start, tokens);
+		}
+	}
+}
+
+void Tokenizer::split(wstring_view line, wstring_view delimiters, bool collapse_delimiters, vector<wstring_view>& tokens) {
+	tokens.clear();
+	const wchar_t* data = line.data();
+	size_t size = line.size();
+	size_t token_start = 0;
+	size_t i = 0;
+
+#ifdef TOKENIZER_SSE2
+	size_t num_delimiters = delimiters.size();
+	if (num_delimiters > 0 && num_delimiters <= MAX_SIMD_DELIMITERS) {
+#ifdef TOKENIZER_AVX2
+		const size_t chars_256 = sizeof(__m256i) / sizeof(wchar_t);
+		__m256i delimiters_256[MAX_SIMD_DELIMITERS];
+		for (size_t d = 0; d < num_delimiters; d++) {
+			delimiters_256[d] = set_char_256(delimiters[d]);
+		}
+		for (; i + chars_256 <= size; i += chars_256) {
+			__m256i chars = _mm256_loadu_si256((const __m256i*)(data + i));
+			__m256i found = equal_chars_256(chars, delimiters_256[0]);
+			for (size_t d = 1; d < num_delimiters; d++) {
+				found = _mm256_or_si256(found, equal_chars_256(chars, delimiters_256[d]));
+			}
+			unsigned int bits = (unsigned int)_mm256_movemask_epi8(found) & char_bit_mask;
+			while (bits != 0) {
+				add_token(data, i + lowest_bit(bits) / sizeof(wchar_t), collapse_delimiters, token_start, tokens);
+				bits &= bits - 1;
+			}
+		}
+#endif
+		const size_t chars_128 = sizeof(__m128i) / sizeof(wchar_t);
+		__m128i delimiters_128[MAX_SIMD_DELIMITERS];
+		for (size_t d = 0; d < num_delimiters; d++) {
+			delimiters_128[d] = set_char_128(delimiters[d]);
+		}
+		for (; i + chars_128 <= size; i += chars_128) {
+			__m128i chars = _mm_loadu_si128((const __m128i*)(data + i));
+			__m128i found = equal_chars_128(chars, delimiters_128[0]);
+			for (size_t d = 1; d < num_delimiters; d++) {
+				found = _mm_or_si128(found, equal_chars_128(chars, delimiters_128[d]));
+			}
+			unsigned int bits = (unsigned int)_mm_movemask_epi8(found) & char_bit_mask;
+			while (bits != 0) {
+				add_token(data, i + lowest_bit(bits) / sizeof(wchar_t), collapse_delimiters, token_start, tokens);
+				bits &= bits - 1;
+			}
+		}
+	}
+#endif
+
+	// rest of the line
+	Tokenizer::split_scalar(data, i, size, delimiters, collapse_delimiters, token_start, tokens);
+
+	// add remaining non-empty token
+	if (token_start < size) {
+		tokens.push_back(wstring_view(data + token_start, size - token_start));
+	}
+}
+
+void Tokenizer::assign(const vector<wstring_view>& tokens, vector<wstring>& strings) {
+	strings.resize(tokens.size());
+	for (size_t i = 0; i < tokens.size(); i++) {
+		strings[i].assign(tokens[i].data(), tokens[i].size());
+	}
+}
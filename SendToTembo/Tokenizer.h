@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+class Tokenizer
+{
+
+private:
+	// scalar version, used for the tail of the line and for more than MAX_SIMD_DELIMITERS delimiters
+	static void split_scalar(const wchar_t*, size_t, size_t, wstring_view, bool, size_t&, vector<wstring_view>&);
+
+public:
+	// delimiter sets up to this size are searched with SSE2/AVX2
+	static const size_t MAX_SIMD_DELIMITERS = 4;
+
+
+	/*************************************************************************************************************************************************************************
+	* This function splits a line on the given delimiters into views
+	*
+	* Input:
+	*		line					wstring_view			line to split, must outlive the tokens
+	*		delimiters				wstring_view			chars to split on (e.g. L" \t" both ' ' and '\t')
+	*		collapse_delimiters		bool					true: 'a  b' -> ['a', 'b'], false: 'a  b' -> ['a', '', 'b']
+	* Output:
+	*		tokens					vector<wstring_view>	views into line, cleared first so the vector can be reused for every line
+	*
+	* Same result as DataReader::strsplit: a trailing empty token is never added.
+	* Delimiters are found 16 (AVX2) or 8 (SSE2) UTF-16 chars at a time, depending on the instruction set the build targets,
+	* otherwise char by char.
+	*
+	*************************************************************************************************************************************************************************/
+	static void split(wstring_view, wstring_view, bool, vector<wstring_view>&);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function copies tokens into strings, reusing the buffers of the strings already in the vector
+	*
+	* Input:
+	*		tokens		vector<wstring_view>	tokens of split
+	* Output:
+	*		strings		vector<wstring>			resized to the number of tokens
+	*
+	*************************************************************************************************************************************************************************/
+	static void assign(const vector<wstring_view>&, vector<wstring>&);
+};
+
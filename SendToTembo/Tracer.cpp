@@ -0,0 +1,132 @@
+#include "Tracer.h"
+#include "JsonWriter.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+Tracer::Tracer(clock::time_point start_time) : start_time(start_time) {
+	// thread creating the tracer is the main thread
+	thread_indices.emplace(this_thread::get_id(), 1);
+}
+
+Tracer::~Tracer() {
+}
+
+void Tracer::add_span(const wstring& category, const wstring& name, clock::time_point begin, clock::time_point end, vector<Arg> args) {
+	Event event;
+	event.category = category;
+	event.name = name;
+	event.start_us = chrono::duration_cast<chrono::microseconds>(begin - start_time).count();
+	event.duration_us = chrono::duration_cast<chrono::microseconds>(end - begin).count();
+	event.args = move(args);
+	lock_guard<mutex> lock(trace_mutex);
+	auto thread_index = thread_indices.emplace(this_thread::get_id(), (int)thread_indices.size() + 1);
+	event.thread_index = thread_index.first->second;
+	events.push_back(move(event));
+}
+
+bool Tracer::write(const wstring& trace_path) {
+	lock_guard<mutex> lock(trace_mutex);
+	JsonWriter out;
+	if (!out.open(trace_path)) {
+		return false;
+	}
+	out.begin_object();
+	out.key(L"traceEvents");
+	out.begin_array();
+	// thread names, so the viewer shows main and workers in order
+	for (auto& thread_index : thread_indices) {
+		out.begin_object();
+		out.key(L"name");
+		out.string_value(L"thread_name");
+		out.key(L"ph");
+		out.string_value(L"M");
+		out.key(L"pid");
+		out.raw_value(L"1");
+		out.key(L"tid");
+		out.raw_value(to_wstring(thread_index.second));
+		out.key(L"args");
+		out.begin_object();
+		out.key(L"name");
+		out.string_value(thread_index.second == 1 ? L"main" : L"thread " + to_wstring(thread_index.second));
+		out.end_object();
+		out.end_object();
+	}
+	for (const Event& event : events) {
+		out.begin_object();
+		out.key(L"name");
+		out.string_value(event.name);
+		out.key(L"cat");
+		out.string_value(event.category);
+		out.key(L"ph");
+		out.string_value(L"X");
+		out.key(L"ts");
+		out.raw_value(to_wstring(event.start_us));
+		out.key(L"dur");
+		out.raw_value(to_wstring(event.duration_us));
+		out.key(L"pid");
+		out.raw_value(L"1");
+		out.key(L"tid");
+		out.raw_value(to_wstring(event.thread_index));
+		if (!event.args.empty()) {
+			out.key(L"args");
+			out.begin_object();
+			for (const Arg& arg : event.args) {
+				out.key(arg.key);
+				if (arg.is_number) {
+					out.raw_value(arg.value);
+				}
+				else {
+					out.string_value(arg.value);
+				}
+			}
+			out.end_object();
+		}
+		out.end_object();
+	}
+	out.end_array();
+	out.key(L"displayTimeUnit");
+	out.string_value(L"ms");
+	out.end_object();
+	return out.close();
+}
+
+void Tracer::clear() {
+	lock_guard<mutex> lock(trace_mutex);
+	events.clear();
+}
+
+TraceSpan::TraceSpan(Tracer* tracer, const wstring& category, const wstring& name) : tracer(tracer) {
+	if (tracer == nullptr) {
+		return;
+	}
+	this->category = category;
+	this->name = name;
+	begin = Tracer::clock::now();
+}
+
+void TraceSpan::arg(const wstring& key, const wstring& value) {
+	if (tracer != nullptr) {
+		args.push_back(Tracer::Arg{ key, value, false });
+	}
+}
+
+void TraceSpan::counter(const wstring& key, int64_t value) {
+	if (tracer != nullptr) {
+		args.push_back(Tracer::Arg{ key, to_wstring(value), true });
+	}
+}
+
+void TraceSpan::end() {
+	if (tracer == nullptr) {
+		return;
+	}
+	tracer->add_span(category, name, begin, Tracer::clock::now(), move(args));
+	tracer = nullptr;
+}
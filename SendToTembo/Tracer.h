@@ -0,0 +1,122 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* Collects timed spans of the conversion and writes them as Chrome trace-event JSON
+*
+* Every span is a complete event (ph X) with start and duration in microseconds since the start time, the thread it ran on and
+* its arguments (counters like rows, data objects, bytes). The trace can be opened in chrome://tracing or ui.perfetto.dev.
+* Spans can be added from several threads at the same time. The thread creating the tracer is thread 1 (main), other threads are numbered in the order of
+* their first span.
+*
+*************************************************************************************************************************************************************************/
+class Tracer
+{
+
+public:
+	typedef chrono::high_resolution_clock clock;
+
+	struct Arg {
+		wstring key;
+		wstring value;
+		// written without "" marks
+		bool is_number;
+	};
+
+private:
+	struct Event {
+		wstring category;
+		wstring name;
+		int64_t start_us;
+		int64_t duration_us;
+		int thread_index;
+		vector<Arg> args;
+	};
+
+	clock::time_point start_time;
+	mutex trace_mutex;
+	vector<Event> events;
+	map<thread::id, int> thread_indices;
+
+public:
+	/*************************************************************************************************************************************************************************
+	* Input:
+	*		start_time		clock::time_point		time 0 of the trace, e.g. start of main(), called on the main thread
+	*
+	*************************************************************************************************************************************************************************/
+	Tracer(clock::time_point start_time = clock::now());
+	~Tracer();
+
+	Tracer(const Tracer&) = delete;
+	Tracer& operator=(const Tracer&) = delete;
+
+	// adds a finished span of the calling thread
+	void add_span(const wstring& category, const wstring& name, clock::time_point begin, clock::time_point end, vector<Arg> args);
+
+
+	/*************************************************************************************************************************************************************************
+	* This function writes all spans added so far
+	*
+	* Input:
+	*		trace_path		wstring		where to store the trace file
+	* Output:
+	*		res				bool		success or not
+	*
+	*************************************************************************************************************************************************************************/
+	bool write(const wstring&);
+
+	// drops all spans, e.g. after they were written for one input folder
+	void clear();
+};
+
+
+/*************************************************************************************************************************************************************************
+* Span from construction to end() or destruction
+*
+* Does nothing if tracer is nullptr, so callers don't have to check whether tracing is on.
+*
+*************************************************************************************************************************************************************************/
+class TraceSpan
+{
+
+private:
+	Tracer* tracer;
+	wstring category;
+	wstring name;
+	Tracer::clock::time_point begin;
+	vector<Tracer::Arg> args;
+
+public:
+	TraceSpan(Tracer* tracer, const wstring& category, const wstring& name);
+	~TraceSpan() { this->end(); }
+
+	TraceSpan(const TraceSpan&) = delete;
+	TraceSpan& operator=(const TraceSpan&) = delete;
+
+	// adds a text argument, e.g. file name
+	void arg(const wstring& key, const wstring& value);
+	// adds a counter, e.g. number of rows
+	void counter(const wstring& key, int64_t value);
+	// finishes the span, later calls do nothing
+	void end();
+};
+
@@ -0,0 +1,348 @@
+#include "WatchDaemon.h"
+#include "CSVReader.h"
+#include "EFFReader.h"
+#include <ctime>
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+namespace filesys = std::experimental::filesystem;
+
+WatchDaemon::WatchDaemon(const wstring& raw_data_folder, chrono::milliseconds settle_time, chrono::milliseconds max_delay) :
+	raw_data_folder(raw_data_folder), settle_time(settle_time), max_delay(max_delay) {
+	wstring root_folder = raw_data_folder.substr(0, raw_data_folder.find_last_of(L"\\"));
+	test_flow_folder = root_folder + L"\\20_TestFlow";
+	report_folder = root_folder + L"\\50_Report";
+	media_reader.set_string_pool(&media_string_pool);
+}
+
+WatchDaemon::~WatchDaemon() {
+}
+
+void WatchDaemon::read_test_flow() {
+	test_flow_catalog.scan(test_flow_folder);
+	raw_configs_struct.clear();
+	vector<wstring> configs_file = test_flow_catalog.get_config_files();
+	if (configs_file.size() > 0) {
+		// e.g. still locked by an editor, read again with its next change
+		try {
+			raw_configs_struct = dr.read_config_file(configs_file[0]);
+		}
+		catch (exception &e) {
+			wcout << L"Couldn't read Config_Tembo.txt file: " << e.what() << endl;
+		}
+	}
+	else {
+		wcout << L"Couldn't read Config_Tembo.txt file" << endl;
+	}
+
+	// same configurations as a normal run
+	is_manual_measurement_data = false;
+	bool use_cache = true;
+	num_upload_threads = 4;
+	staging_area_override = L"";
+	wstring config_json_format = L"pretty";
+	for (map<wstring, wstring>::value_type& config : raw_configs_struct) {
+		wstring key = dr.convert_to_lower(config.first);
+		if (L"basic_type" == config.first) {
+			is_manual_measurement_data = true;
+		}
+		if (key == L"cache" && config.second == L"0") {
+			use_cache = false;
+		}
+		if (key == L"uploadthreads") {
+			try {
+				num_upload_threads = max(1, stoi(config.second));
+			}
+			catch (exception &e) {
+				wcout << L"Invalid UploadThreads value in Config_Tembo.txt, using 4" << endl;
+			}
+		}
+		if (key == L"stagingarea") {
+			staging_area_override = config.second;
+		}
+		if (key == L"jsonformat") {
+			config_json_format = dr.convert_to_lower(config.second);
+		}
+	}
+	compact_json = (json_format.empty() ? config_json_format : json_format) == L"compact";
+	conversion_cache.reset(new ConversionCache(use_cache ? report_folder + L"\\.cache" : L""));
+
+	limits_struct.clear();
+	vector<wstring> test_limits_file = test_flow_catalog.get_limits_files();
+	if (test_limits_file.size() > 0) {
+		CSVReader cr;
+		cr.set_conversion_cache(conversion_cache->is_enabled() ? conversion_cache.get() : nullptr);
+		try {
+			limits_struct = cr.read_limits_file(test_limits_file[0]);
+		}
+		catch (exception &e) {
+			wcout << L"Couldn't read testlimits.txt file: " << e.what() << endl;
+		}
+	}
+}
+
+void WatchDaemon::mark_all_pending(clock::time_point changed) {
+	for (const wstring& eff_file : raw_data_catalog.get_eff_files()) {
+		pending_eff_files[eff_file] = changed;
+	}
+	if (!raw_data_catalog.get_csv_files().empty()) {
+		this->mark_csv_report_pending(changed);
+	}
+}
+
+void WatchDaemon::mark_csv_report_pending(clock::time_point changed) {
+	if (!csv_report_pending) {
+		csv_report_pending = true;
+		csv_report_pending_since = changed;
+	}
+	csv_report_changed = changed;
+}
+
+void WatchDaemon::handle_change(const FolderWatcher::Change& change) {
+	clock::time_point now = clock::now();
+	// configurations and limits are small, read again on any change in 20_TestFlow
+	if (change.path.compare(0, test_flow_folder.size() + 1, test_flow_folder + L"\\") == 0) {
+		wstring file_name = dr.convert_to_lower(change.path.substr(change.path.find_last_of(L"\\") + 1));
+		if (file_name == L"config_tembo.txt") {
+			wcout << L"Changed: " << change.path << endl;
+			this->read_test_flow();
+			this->mark_all_pending(now);
+		}
+		else if (file_name == L"testlimits.txt") {
+			// limits are only used for CSV files
+			wcout << L"Changed: " << change.path << endl;
+			this->read_test_flow();
+			if (!raw_data_catalog.get_csv_files().empty()) {
+				this->mark_csv_report_pending(now);
+			}
+		}
+		return;
+	}
+
+	if (change.action == FolderWatcher::REMOVED || change.action == FolderWatcher::RENAMED_OLD_NAME) {
+		if (raw_data_catalog.remove_path(change.path)) {
+			wcout << L"Removed: " << change.path << endl;
+			media_reader.remove_media_path(change.path, png_index);
+			media_reader.remove_media_path(change.path, mat_index);
+			pending_eff_files.erase(change.path);
+			// report of an EFF file stays, CSV report is written without the removed inputs
+			if (dr.convert_to_lower(filesys::path(change.path).extension().wstring()) != L".eff") {
+				this->mark_csv_report_pending(now);
+			}
+		}
+		return;
+	}
+
+	error_code ec;
+	if (filesys::is_directory(change.path, ec)) {
+		// a modified folder only means that files in it changed, they are reported themselves
+		if (change.action != FolderWatcher::ADDED && change.action != FolderWatcher::RENAMED_NEW_NAME) {
+			return;
+		}
+		// folder moved or copied in, its files aren't reported one by one
+		InputCatalog folder_catalog;
+		folder_catalog.scan(change.path);
+		const vector<wstring>* lists[] = { &folder_catalog.get_csv_files(), &folder_catalog.get_eff_files(),
+			&folder_catalog.get_png_files(), &folder_catalog.get_mat_files() };
+		for (auto list : lists) {
+			for (const wstring& file : *list) {
+				this->handle_raw_data_file(file, now);
+			}
+		}
+		return;
+	}
+	this->handle_raw_data_file(change.path, now);
+}
+
+void WatchDaemon::handle_raw_data_file(const wstring& file_path, clock::time_point now) {
+	raw_data_catalog.add_file(file_path);
+	wstring extension = dr.convert_to_lower(filesys::path(file_path).extension().wstring());
+	if (extension == L".eff") {
+		pending_eff_files[file_path] = now;
+	}
+	// new png and mat files can be linked by rows written before
+	else if (extension == L".csv" || extension == L".png" || extension == L".mat") {
+		if (extension == L".png") {
+			media_reader.add_media_file(file_path, png_index);
+		}
+		else if (extension == L".mat") {
+			media_reader.add_media_file(file_path, mat_index);
+		}
+		this->mark_csv_report_pending(now);
+	}
+}
+
+void WatchDaemon::build_media_index() {
+	media_reader.build_media_index(raw_data_catalog.get_png_files(), png_index);
+	media_reader.build_media_index(raw_data_catalog.get_mat_files(), mat_index);
+}
+
+wstring WatchDaemon::create_out_folder() {
+	// same name as the folder of a normal run
+	time_t theTime = time(NULL);
+	struct tm *aTime = localtime(&theTime);
+	wstring out_folder_path = report_folder + L"\\" + to_wstring(aTime->tm_year + 1900) + to_wstring(aTime->tm_mon + 1) +
+		to_wstring(aTime->tm_mday) + L"T" + to_wstring(aTime->tm_hour) + to_wstring(aTime->tm_min) + to_wstring(aTime->tm_sec);
+	error_code ec;
+	filesys::create_directories(out_folder_path, ec);
+	return ec ? L"" : out_folder_path;
+}
+
+wstring WatchDaemon::get_staging_area(map<wstring, wstring>& configs_struct) {
+	if (!staging_area_override.empty()) {
+		return staging_area_override;
+	}
+	wstring prj_name = configs_struct[L"Project"];
+	transform(prj_name.begin(), prj_name.end(), prj_name.begin(), ::toupper);
+	return wstring(L"\\\\VIHSDV002.infineon.com\\tembo_staging_prod\\") + prj_name + L"\\job";
+}
+
+bool WatchDaemon::convert_settled() {
+	clock::time_point now = clock::now();
+	vector<wstring> settled_eff_files;
+	for (auto& pending : pending_eff_files) {
+		if (now - pending.second >= settle_time) {
+			settled_eff_files.push_back(pending.first);
+		}
+	}
+	// a single timer for all inputs of the report would be reset by every change of any of them
+	bool csv_report_settled = csv_report_pending && (now - csv_report_changed >= settle_time || now - csv_report_pending_since >= max_delay);
+	if (settled_eff_files.empty() && !csv_report_settled) {
+		return false;
+	}
+
+	wstring out_folder_path = this->create_out_folder();
+	if (out_folder_path.empty()) {
+		wcout << L"Failed to create directory!" << endl;
+		return false;
+	}
+	// a report which can't be converted (e.g. invalid unit) is skipped until its inputs change again, the daemon keeps running
+	for (const wstring& eff_file : settled_eff_files) {
+		pending_eff_files.erase(eff_file);
+		try {
+			this->convert_eff_file(eff_file, out_folder_path);
+		}
+		catch (exception &e) {
+			wcout << L"Conversion failed: " << e.what() << endl;
+		}
+	}
+	if (csv_report_settled) {
+		csv_report_pending = false;
+		try {
+			this->convert_csv_report(out_folder_path);
+		}
+		catch (exception &e) {
+			wcout << L"Conversion failed: " << e.what() << endl;
+		}
+	}
+	return true;
+}
+
+void WatchDaemon::convert_eff_file(const wstring& eff_file, const wstring& out_folder_path) {
+	map<wstring, wstring> configs_struct = dr.setup_configurations(raw_configs_struct, false);
+	wstring staging_area = this->get_staging_area(configs_struct);
+	EFFReader er;
+	er.set_conversion_cache(conversion_cache->is_enabled() ? conversion_cache.get() : nullptr);
+	er.set_compact_json(compact_json);
+	wcout << L"Reading EFF file: " << eff_file << endl;
+	if (!er.eff_to_json(eff_file, configs_struct, out_folder_path)) {
+		return;
+	}
+	wcout << L"Staging area location" << endl << staging_area << endl << endl;
+	wstring base_filename = eff_file.substr(eff_file.find_last_of(L"/\\") + 1);
+	wstring report_name = base_filename.substr(0, base_filename.find_last_of('.'));
+	StagingUploader uploader(unique_ptr<UploadDestination>(new FolderDestination(staging_area)), num_upload_threads);
+	uploader.add_last(out_folder_path + L"\\" + report_name + L".json");
+	uploader.finish(wcout);
+}
+
+void WatchDaemon::convert_csv_report(const wstring& out_folder_path) {
+	const vector<wstring>& csv_files = raw_data_catalog.get_csv_files();
+	if (csv_files.empty()) {
+		return;
+	}
+	map<wstring, wstring> configs_struct = is_manual_measurement_data ? raw_configs_struct : dr.setup_configurations(raw_configs_struct, true);
+	wstring staging_area = this->get_staging_area(configs_struct);
+	CSVReader cr;
+	cr.set_conversion_cache(conversion_cache->is_enabled() ? conversion_cache.get() : nullptr);
+	cr.set_compact_json(compact_json);
+	cr.set_media_index(&png_index, &mat_index);
+
+	// png and mat files which weren't copied yet, while the JSON is generated
+	StagingUploader uploader(unique_ptr<UploadDestination>(new FolderDestination(staging_area)), num_upload_threads);
+	vector<wstring> new_media;
+	for (auto png_file : raw_data_catalog.get_png_files()) {
+		if (dr.convert_to_lower(png_file).find(L"report-picture") != wstring::npos && staged_media.insert(png_file).second) {
+			new_media.push_back(png_file);
+		}
+	}
+	for (auto mat_file : raw_data_catalog.get_mat_files()) {
+		if (dr.convert_to_lower(mat_file).find(L"report-waveform") != wstring::npos && staged_media.insert(mat_file).second) {
+			new_media.push_back(mat_file);
+		}
+	}
+	for (const wstring& media_file : new_media) {
+		uploader.add(media_file);
+	}
+
+	wcout << L"Converting " << csv_files.size() << L" CSV files" << endl;
+	if (cr.csvs_to_json(csv_files, limits_struct, configs_struct, out_folder_path, raw_data_catalog.get_png_files(), raw_data_catalog.get_mat_files())) {
+		wcout << L"Staging area location" << endl << staging_area << endl << endl;
+		uploader.add_last(out_folder_path + L"\\" + configs_struct[L"ReportName"] + L".json");
+	}
+	// JSON is skipped if any of the new media files couldn't be copied
+	if (!uploader.finish(wcout)) {
+		// copied again with the next report
+		for (const wstring& media_file : new_media) {
+			staged_media.erase(media_file);
+		}
+	}
+}
+
+int WatchDaemon::run() {
+	wcout << L"Scanning " << raw_data_folder << endl;
+	this->read_test_flow();
+	raw_data_catalog.scan(raw_data_folder);
+	this->build_media_index();
+
+	FolderWatcher watcher;
+	if (!watcher.watch(raw_data_folder)) {
+		wcout << L"Couldn't watch folder: " << raw_data_folder << endl;
+		return 1;
+	}
+	if (!watcher.watch(test_flow_folder)) {
+		wcout << L"Couldn't watch folder: " << test_flow_folder << endl;
+	}
+
+	// convert everything once without waiting, unchanged files come from the cache
+	this->mark_all_pending(clock::now() - settle_time);
+	this->convert_settled();
+	wcout << endl << L"Watching " << raw_data_folder << L" (Ctrl+C to stop)" << endl;
+
+	vector<FolderWatcher::Change> changes;
+	while (true) {
+		bool overflow = watcher.wait(changes, chrono::milliseconds(500));
+		if (overflow) {
+			// changes were dropped, scan again like at start
+			wcout << L"Too many changes at once, scanning " << raw_data_folder << L" again" << endl;
+			this->read_test_flow();
+			raw_data_catalog.scan(raw_data_folder);
+			this->build_media_index();
+			this->mark_all_pending(clock::now());
+		}
+		for (const FolderWatcher::Change& change : changes) {
+			this->handle_change(change);
+		}
+		if (this->convert_settled()) {
+			wcout << endl << L"Watching " << raw_data_folder << L" (Ctrl+C to stop)" << endl;
+		}
+	}
+	return 0;
+}
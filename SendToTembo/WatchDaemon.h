@@ -0,0 +1,129 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <memory>
+#include <chrono>
+#include <iostream>
+#include "DataReader.h"
+#include "CSVReader.h"
+#include "InputCatalog.h"
+#include "ConversionCache.h"
+#include "StagingUploader.h"
+#include "FolderWatcher.h"
+
+/*************************************************************************************************************************************************************************
+* maintainer Xing Jin (IFAG ATV PS PD MUC CVSV)
+* since v4.1.0
+*
+* date		18.10.2026
+*
+* author	Xing Jin (IFAG ATV PS PD MUC CVSV)
+*************************************************************************************************************************************************************************/
+
+using namespace std;
+
+#pragma once
+/*************************************************************************************************************************************************************************
+* Long running conversion of a 30_RawData folder, started with --watch <30_RawData folder>
+*
+* Folders are scanned once at start, afterwards catalog, configurations and limits are kept in memory and only updated from the
+* changes FolderWatcher reports for 30_RawData and 20_TestFlow.
+* A changed EFF file is converted into its own report, a changed CSV, png or mat file converts the CSV report again. Files are
+* converted once nothing changed for settle_time, so files which are still being written are not read half way. The CSV report
+* is converted at the latest max_delay after its first change, even if some of its inputs keep changing.
+* Unchanged CSV files of the report are loaded from the conversion cache (50_Report\.cache), only changed files are parsed again.
+* The media index of the png and mat files is kept as well and only updated for added or removed files.
+* A folder added or renamed into 30_RawData is scanned for its files, a folder which is only modified (files in it changed) isn't.
+* Every conversion writes a new 50_Report\<time> folder like a normal run and the JSON is copied to the staging area, png and mat
+* files only once.
+*
+*************************************************************************************************************************************************************************/
+class WatchDaemon
+{
+
+private:
+	typedef chrono::steady_clock clock;
+
+	wstring raw_data_folder;
+	wstring test_flow_folder;
+	wstring report_folder;
+	chrono::milliseconds settle_time;
+	chrono::milliseconds max_delay;
+
+	DataReader dr;
+	InputCatalog raw_data_catalog;
+	InputCatalog test_flow_catalog;
+	// png and mat files of raw_data_catalog prepared for matching, updated file by file instead of built again for every report.
+	// Links of the files are interned in media_string_pool, which lives as long as the daemon
+	StringPool media_string_pool;
+	CSVReader media_reader;
+	CSVReader::MediaIndex png_index;
+	CSVReader::MediaIndex mat_index;
+	map<wstring, wstring> raw_configs_struct;
+	LimitsIndex limits_struct;
+	bool is_manual_measurement_data = false;
+	unique_ptr<ConversionCache> conversion_cache;
+	unsigned int num_upload_threads = 4;
+	wstring staging_area_override;
+	// compact or pretty from the command line, empty uses 'JsonFormat' of Config_Tembo.txt
+	wstring json_format;
+	bool compact_json = false;
+	// png and mat files already copied to the staging area
+	set<wstring> staged_media;
+
+	// EFF files waiting to be converted and time of their last change
+	map<wstring, clock::time_point> pending_eff_files;
+	// CSV report has to be converted again, time of first and last change of any of its inputs since it was converted
+	bool csv_report_pending = false;
+	clock::time_point csv_report_pending_since;
+	clock::time_point csv_report_changed;
+
+	// reads Config_Tembo.txt and testlimits.txt of 20_TestFlow
+	void read_test_flow();
+	// prepares png_index and mat_index of all files in raw_data_catalog, after a scan
+	void build_media_index();
+	// marks all EFF files and the CSV report as changed at the given time, e.g. after configurations changed
+	void mark_all_pending(clock::time_point changed);
+	// marks the CSV report as changed, keeps the time of the first change while it is pending
+	void mark_csv_report_pending(clock::time_point changed);
+	void handle_change(const FolderWatcher::Change&);
+	// adds a file which was created or changed in 30_RawData
+	void handle_raw_data_file(const wstring& file_path, clock::time_point now);
+	// converts everything which didn't change for settle_time and the CSV report after max_delay, returns whether anything was converted
+	bool convert_settled();
+	wstring create_out_folder();
+	wstring get_staging_area(map<wstring, wstring>& configs_struct);
+	void convert_eff_file(const wstring& eff_file, const wstring& out_folder_path);
+	void convert_csv_report(const wstring& out_folder_path);
+
+public:
+	/*************************************************************************************************************************************************************************
+	* Input:
+	*		raw_data_folder		wstring					30_RawData folder to watch, 20_TestFlow and 50_Report are next to it
+	*		settle_time			chrono::milliseconds	time without changes before a file is converted
+	*		max_delay			chrono::milliseconds	longest time the CSV report waits, if its inputs never stop changing together
+	*
+	* All CSV files of a folder go into one report, while a tester is running one of them usually changes every few seconds. After
+	* max_delay the report is converted anyway, files which are still written are converted again with their next change.
+	*
+	*************************************************************************************************************************************************************************/
+	WatchDaemon(const wstring&, chrono::milliseconds settle_time = chrono::milliseconds(2000), chrono::milliseconds max_delay = chrono::milliseconds(30000));
+	~WatchDaemon();
+
+	// JSON layout from the command line (compact, pretty), overrides Config_Tembo.txt, call before run
+	void set_json_format(const wstring& json_format) { this->json_format = json_format; }
+
+
+	/*************************************************************************************************************************************************************************
+	* This function converts all inputs once and then keeps converting changed inputs
+	*
+	* Output:
+	*		res			int			exit code, returns only if the folders can't be watched
+	*
+	*************************************************************************************************************************************************************************/
+	int run();
+};
+